@@ -0,0 +1,102 @@
+//  BWArena.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWArena.h"
+#include <new>
+
+namespace bw {
+
+// MARK: - constructors
+
+BWArena::~BWArena() {
+    trim();
+}
+
+// MARK: - arena methods
+
+void * BWArena::alloc(size_t size) {
+    if(!size) {
+        size = 1;
+    }
+    ++_stats.allocs;
+    int k = _class_for(size);
+    if(k < 0) {
+        // too big to pool
+        ++_stats.heap_allocs;
+        _stats.bytes_in_use += size;
+        return ::operator new(size);
+    }
+    size_t block_size = min_block << k;
+    _stats.bytes_in_use += block_size;
+    if(_free[k]) {
+        Block * block = _free[k];
+        _free[k] = block->next;
+        ++_stats.reuses;
+        _stats.bytes_free -= block_size;
+        return block;
+    }
+    ++_stats.heap_allocs;
+    return ::operator new(block_size);
+}
+
+void BWArena::dealloc(void * ptr, size_t size) {
+    if(!ptr) {
+        return;
+    }
+    if(!size) {
+        size = 1;
+    }
+    ++_stats.frees;
+    int k = _class_for(size);
+    if(k < 0) {
+        _stats.bytes_in_use -= size;
+        ::operator delete(ptr);
+        return;
+    }
+    size_t block_size = min_block << k;
+    _stats.bytes_in_use -= block_size;
+    _stats.bytes_free += block_size;
+    Block * block = (Block *) ptr;
+    block->next = _free[k];
+    _free[k] = block;
+}
+
+void BWArena::trim() {
+    for(int k = 0; k < num_classes; ++k) {
+        while(_free[k]) {
+            Block * block = _free[k];
+            _free[k] = block->next;
+            ::operator delete(block);
+        }
+    }
+    _stats.bytes_free = 0;
+}
+
+BWArenaStats BWArena::stats() const {
+    return _stats;
+}
+
+// the byte counts describe current state, so they stay
+void BWArena::reset_stats() {
+    _stats.allocs = 0;
+    _stats.frees = 0;
+    _stats.heap_allocs = 0;
+    _stats.reuses = 0;
+}
+
+// MARK: - private
+
+// smallest class that fits size, or -1 if none
+int BWArena::_class_for(size_t size) {
+    size_t block_size = min_block;
+    for(int k = 0; k < num_classes; ++k) {
+        if(size <= block_size) {
+            return k;
+        }
+        block_size <<= 1;
+    }
+    return -1;
+}
+
+}
@@ -0,0 +1,65 @@
+//  BWArena.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWARENA_H
+#define BWARENA_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bw {
+
+struct BWArenaStats {
+    uint64_t allocs = 0;
+    uint64_t frees = 0;
+    uint64_t heap_allocs = 0;   // had to go to operator new
+    uint64_t reuses = 0;        // served from a free list
+    uint64_t bytes_in_use = 0;
+    uint64_t bytes_free = 0;    // held on free lists
+};
+
+// recycling allocator for short-lived buffers
+// blocks are rounded up to a power of two and kept on a free list
+// per size class when freed, so a steady workload stops allocating
+// not thread safe – one per connection
+class BWArena {
+    static constexpr int num_classes = 12;          // 16 bytes to 32 KiB
+    static constexpr size_t min_block = 16;
+
+    struct Block {
+        Block * next;
+    };
+
+    Block * _free[num_classes] = {};
+    BWArenaStats _stats;
+
+public:
+    BWArena() = default;
+    ~BWArena();
+
+    void * alloc(size_t size);
+    void dealloc(void * ptr, size_t size);  // size as passed to alloc()
+    void trim();                            // give free lists back to the heap
+
+    template<typename T> T * alloc_array(size_t count) {
+        return (T *) alloc(count * sizeof(T));
+    }
+    template<typename T> void dealloc_array(T * ptr, size_t count) {
+        dealloc((void *) ptr, count * sizeof(T));
+    }
+
+    BWArenaStats stats() const;
+    void reset_stats();
+
+    // rule of five stuff
+    BWArena(const BWArena &)                = delete;   // no copy
+    BWArena & operator = (const BWArena &)  = delete;   // no assignment
+
+private:
+    static int _class_for(size_t size);
+};
+
+}
+
+#endif // BWARENA_H
@@ -0,0 +1,164 @@
+//  BWAsync.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWAsync.h"
+
+namespace bw {
+
+// MARK: - constructors
+
+// only the DB thread uses the connection, so it doesn't need sqlite's mutex
+AsyncBWSQL::AsyncBWSQL(const char * filename, size_t queue_capacity, int flags)
+: _filename(filename), _capacity(queue_capacity ? queue_capacity : 1)
+{
+    _db = std::make_unique<BWSQL>(_filename.c_str(), flags | SQLITE_OPEN_NOMUTEX);
+    _worker = std::thread(&AsyncBWSQL::_run, this);
+}
+
+AsyncBWSQL::~AsyncBWSQL() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stop = true;
+    }
+    _have_job.notify_one();
+    if(_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+// MARK: - utilities
+
+AsyncStats AsyncBWSQL::stats() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    AsyncStats s = _stats;
+    s.queue_depth = (int) _queue.size();
+    return s;
+}
+
+const char * AsyncBWSQL::filename() const {
+    return _filename.c_str();
+}
+
+// MARK: - private
+
+// SQLITE_OK when queued, SQLITE_FULL when the queue is full and block
+// is false, SQLITE_MISUSE when stopped – that job is completed here,
+// so a caller waiting on it doesn't wait forever
+// the DB thread never waits for space – it's the only thread that
+// makes any, so a callback (or a coroutine resumed inline) that submits
+// again goes over capacity instead
+int AsyncBWSQL::_enqueue(Job && job, bool block) {
+    bool db_thread = std::this_thread::get_id() == _worker.get_id();
+    bool stopped = false;
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        if(_queue.size() >= _capacity && !db_thread && !_stop) {
+            if(!block) {
+                ++_stats.rejected;
+                return SQLITE_FULL;
+            }
+            _have_space.wait(lock, [this] { return _queue.size() < _capacity || _stop; });
+        }
+        if(_stop) {
+            ++_stats.rejected;
+            stopped = true;
+        } else {
+            job.submitted = clock::now();
+            _queue.push_back(std::move(job));
+            ++_stats.submitted;
+            if((int) _queue.size() > _stats.max_queue_depth) {
+                _stats.max_queue_depth = (int) _queue.size();
+            }
+        }
+    }
+    if(stopped) {
+        AsyncResult result;
+        result.rc = SQLITE_MISUSE;
+        result.error = "AsyncBWSQL is stopped";
+        _complete(job, std::move(result));
+        return SQLITE_MISUSE;
+    }
+    _have_job.notify_one();
+    return SQLITE_OK;
+}
+
+// DB thread – runs jobs in order until stopped and drained
+void AsyncBWSQL::_run() {
+    while(true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _have_job.wait(lock, [this] { return !_queue.empty() || _stop; });
+            if(_queue.empty()) {
+                break;
+            }
+            job = std::move(_queue.front());
+            _queue.pop_front();
+        }
+        _have_space.notify_one();
+        _execute(job);
+    }
+}
+
+void AsyncBWSQL::_execute(Job & job) {
+    clock::time_point start = clock::now();
+    AsyncResult result;
+    result.queue_ms = std::chrono::duration<double, std::milli>(start - job.submitted).count();
+
+    Statement st(*_db, job.sql.c_str());
+    sqlite3_stmt * stmt = st.stmt();
+    if(!stmt) {
+        result.rc = sqlite3_errcode(_db->db());
+        result.error = sqlite3_errmsg(_db->db());
+    } else if(sqlite3_bind_parameter_count(stmt) != (int) job.params.size()) {
+        result.rc = SQLITE_RANGE;
+        result.error = "wrong number of bind parameters";
+    } else {
+        int rc = SQLITE_OK;
+        for(size_t index = 0; rc == SQLITE_OK && index < job.params.size(); ++index) {
+            rc = bind_param(stmt, (int) index + 1, job.params[index]);
+        }
+        int num_columns = st.num_columns();
+        for(int col = 0; col < num_columns; ++col) {
+            result.columns.emplace_back(sqlite3_column_name(stmt, col));
+        }
+        if(rc == SQLITE_OK) {
+            while((rc = st.step()) == SQLITE_ROW) {
+                Row & row = result.rows.emplace_back((size_t) num_columns);
+                for(int col = 0; col < num_columns; ++col) {
+                    row[(size_t) col].set_column(stmt, col);
+                }
+            }
+        }
+        result.rc = rc;
+        if(rc != SQLITE_DONE) {
+            result.error = sqlite3_errmsg(_db->db());
+        }
+        result.changes = sqlite3_changes(_db->db());
+        result.last_insert_rowid = sqlite3_last_insert_rowid(_db->db());
+        st.reset();
+    }
+
+    result.exec_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        ++_stats.completed;
+        _stats.queue_ms_total += result.queue_ms;
+        _stats.exec_ms_total += result.exec_ms;
+        if(result.queue_ms > _stats.queue_ms_max) _stats.queue_ms_max = result.queue_ms;
+        if(result.exec_ms > _stats.exec_ms_max) _stats.exec_ms_max = result.exec_ms;
+    }
+
+    _complete(job, std::move(result));
+}
+
+void AsyncBWSQL::_complete(Job & job, AsyncResult && result) {
+    if(job.callback) {
+        job.callback(std::move(result));
+    } else {
+        job.promise.set_value(std::move(result));
+    }
+}
+
+}
@@ -0,0 +1,153 @@
+//  BWAsync.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWASYNC_H
+#define BWASYNC_H
+
+#include "BWSQL.h"
+#include "BWCursor.h"
+#include "BWValue.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bw {
+
+#define DEFAULT_ASYNC_QUEUE 1024
+
+// everything a statement returned, copied off the DB thread
+struct AsyncResult {
+    int rc = SQLITE_OK;         // SQLITE_DONE on success, or the error
+    std::string error;
+    int changes = 0;
+    int64_t last_insert_rowid = 0;
+    std::vector<std::string> columns;
+    std::vector<Row> rows;
+    double queue_ms = 0;        // waiting for the DB thread
+    double exec_ms = 0;         // prepare, bind and step
+
+    bool ok() const { return rc == SQLITE_DONE; }
+};
+
+struct AsyncStats {
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t rejected = 0;      // try_submit() on a full queue, or any submit after stop
+    int queue_depth = 0;
+    int max_queue_depth = 0;
+    double queue_ms_total = 0;
+    double queue_ms_max = 0;
+    double exec_ms_total = 0;
+    double exec_ms_max = 0;
+};
+
+// a connection owned by a dedicated DB thread
+// statements are queued with their parameters and run in order;
+// results come back through a std::future or a completion callback
+// callbacks run on the DB thread, so keep them short
+// a submit from a callback doesn't block, it goes over the queue capacity
+// a submit after the queue is stopped completes at once with SQLITE_MISUSE,
+// its callback on the submitting thread
+class AsyncBWSQL {
+    using clock = std::chrono::steady_clock;
+    using Callback = std::function<void(AsyncResult &&)>;
+
+    struct Job {
+        std::string sql;
+        std::vector<Value> params;
+        std::promise<AsyncResult> promise;
+        Callback callback;
+        clock::time_point submitted;
+    };
+
+    std::string _filename;
+    std::unique_ptr<BWSQL> _db;
+    std::deque<Job> _queue;
+    size_t _capacity;
+    bool _stop = false;
+    AsyncStats _stats;
+    mutable std::mutex _lock;
+    std::condition_variable _have_job;
+    std::condition_variable _have_space;
+    std::thread _worker;
+
+public:
+    // ctor/dtor
+    AsyncBWSQL(const char * filename, size_t queue_capacity = DEFAULT_ASYNC_QUEUE,
+               int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    ~AsyncBWSQL();      // finishes the queue first
+
+    // blocks while the queue is full
+    template<typename... Args> std::future<AsyncResult> submit(const char * sql, Args &&... args);
+    // an invalid future if the queue is full
+    template<typename... Args> std::future<AsyncResult> try_submit(const char * sql, Args &&... args);
+    // callback(AsyncResult &&) on the DB thread, blocks while the queue is full
+    // false if the queue is stopped – the callback has already run
+    template<typename F, typename... Args> bool submit_with(F && callback, const char * sql, Args &&... args);
+    template<typename F> bool submit_values(F && callback, const char * sql, std::vector<Value> params);
+
+    // utilities
+    AsyncStats stats() const;
+    const char * filename() const;
+
+    AsyncBWSQL(const AsyncBWSQL &)                = delete;
+    AsyncBWSQL & operator = (const AsyncBWSQL &)  = delete;
+
+private:
+    int _enqueue(Job && job, bool block);
+    static void _complete(Job & job, AsyncResult && result);
+    void _run();
+    void _execute(Job & job);
+};
+
+template<typename... Args>
+std::future<AsyncResult> AsyncBWSQL::submit(const char * sql, Args &&... args) {
+    Job job;
+    job.sql = sql;
+    (job.params.emplace_back(std::forward<Args>(args)), ...);
+    std::future<AsyncResult> f = job.promise.get_future();
+    _enqueue(std::move(job), true);
+    return f;
+}
+
+template<typename... Args>
+std::future<AsyncResult> AsyncBWSQL::try_submit(const char * sql, Args &&... args) {
+    Job job;
+    job.sql = sql;
+    (job.params.emplace_back(std::forward<Args>(args)), ...);
+    std::future<AsyncResult> f = job.promise.get_future();
+    if(_enqueue(std::move(job), false) == SQLITE_FULL) {
+        return std::future<AsyncResult>();
+    }
+    return f;
+}
+
+template<typename F, typename... Args>
+bool AsyncBWSQL::submit_with(F && callback, const char * sql, Args &&... args) {
+    Job job;
+    job.sql = sql;
+    (job.params.emplace_back(std::forward<Args>(args)), ...);
+    job.callback = std::forward<F>(callback);
+    return _enqueue(std::move(job), true) == SQLITE_OK;
+}
+
+template<typename F>
+bool AsyncBWSQL::submit_values(F && callback, const char * sql, std::vector<Value> params) {
+    Job job;
+    job.sql = sql;
+    job.params = std::move(params);
+    job.callback = std::forward<F>(callback);
+    return _enqueue(std::move(job), true) == SQLITE_OK;
+}
+
+}
+
+#endif // BWASYNC_H
@@ -0,0 +1,200 @@
+//  BWBackup.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWBackup.h"
+
+namespace bw {
+
+// MARK: - constructors
+
+// a named file is read through its own connection, anything else
+// (":memory:", a temp database) through source itself
+BWBackup::BWBackup(sqlite3 * source, const char * dest, int pages, int yield_ms)
+: _dest(dest ? dest : ""), _pages(pages > 0 ? pages : DEFAULT_BACKUP_PAGES),
+  _yield_ms(yield_ms >= 0 ? yield_ms : DEFAULT_BACKUP_YIELD_MS)
+{
+    const char * filename = source ? sqlite3_db_filename(source, "main") : nullptr;
+    if(filename && *filename) {
+        _source = filename;
+    } else {
+        _live = source;
+    }
+}
+
+BWBackup::~BWBackup() {
+    cancel();
+    wait();
+}
+
+// MARK: - backup methods
+
+// the worker reads both without a lock, so they're fixed once it starts
+bool BWBackup::on_progress(std::function<void(const BWBackupProgress &)> f) {
+    if(_worker.joinable()) {
+        return false;
+    }
+    _on_progress = std::move(f);
+    return true;
+}
+
+bool BWBackup::max_restarts(int restarts) {
+    if(_worker.joinable()) {
+        return false;
+    }
+    _max_restarts = restarts >= 0 ? restarts : 0;
+    return true;
+}
+
+bool BWBackup::start() {
+    if(_worker.joinable() || _dest.empty() || (_source.empty() && !_live)) {
+        return false;
+    }
+    _worker = std::thread(&BWBackup::_run, this);
+    return true;
+}
+
+int BWBackup::wait() {
+    if(_worker.joinable()) {
+        _worker.join();
+    }
+    std::lock_guard<std::mutex> guard(_lock);
+    return _progress.rc;
+}
+
+void BWBackup::cancel() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _cancel = true;
+    }
+    _wake.notify_one();
+}
+
+// MARK: - utilities
+
+BWBackupProgress BWBackup::progress() {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _progress;
+}
+
+const char * BWBackup::dest() const {
+    return _dest.c_str();
+}
+
+// MARK: - private
+
+void BWBackup::_run() {
+    clock::time_point start = clock::now();
+    sqlite3 * src = _live;
+    sqlite3 * dst = nullptr;
+    sqlite3_backup * backup = nullptr;
+    int rc = SQLITE_OK;
+
+    if(!_live) {
+        rc = sqlite3_open_v2(_source.c_str(), &src, SQLITE_OPEN_READONLY, nullptr);
+        sqlite3_busy_timeout(src, DEFAULT_BACKUP_BUSY_TIMEOUT);
+    }
+    if(rc == SQLITE_OK) {
+        rc = sqlite3_open_v2(_dest.c_str(), &dst, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+        sqlite3_busy_timeout(dst, DEFAULT_BACKUP_BUSY_TIMEOUT);
+    }
+    if(rc == SQLITE_OK) {
+        backup = sqlite3_backup_init(dst, "main", src, "main");
+        if(!backup) {
+            rc = sqlite3_errcode(dst);
+        }
+    }
+    if(rc != SQLITE_OK) {
+        printf("BWBackup %s: %s\n", _dest.c_str(), sqlite3_errmsg(dst ? dst : src));
+    }
+
+    int last_done = 0;
+    bool final_pass = false;
+    bool can_finish = _live || _is_wal(src);      // a single step that doesn't block writers
+    while(backup) {
+        int step_rc = sqlite3_backup_step(backup, final_pass ? -1 : _pages);
+        int total = sqlite3_backup_pagecount(backup);
+        int remaining = sqlite3_backup_remaining(backup);
+        int done = total - remaining;
+        BWBackupProgress snapshot;
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            ++_progress.steps;
+            if(step_rc == SQLITE_BUSY || step_rc == SQLITE_LOCKED) {
+                ++_progress.busy;
+            } else {
+                // every step moves forward, so no more pages done than
+                // last time means sqlite started over
+                if(last_done > 0 && done <= last_done) {
+                    ++_progress.restarts;
+                    _progress.copied += done;
+                } else {
+                    _progress.copied += done - last_done;
+                }
+                last_done = done;
+            }
+            _progress.total = total;
+            _progress.remaining = remaining;
+            _progress.elapsed_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+            _progress.pages_per_sec = _progress.elapsed_ms > 0
+                ? (double) _progress.copied * 1000.0 / _progress.elapsed_ms : 0;
+            if(can_finish && _progress.restarts > _max_restarts) {
+                final_pass = true;
+            }
+            snapshot = _progress;
+        }
+        if(_on_progress) {
+            _on_progress(snapshot);
+        }
+
+        if(step_rc == SQLITE_DONE) {
+            rc = SQLITE_DONE;
+            break;
+        }
+        if(step_rc != SQLITE_OK && step_rc != SQLITE_BUSY && step_rc != SQLITE_LOCKED) {
+            rc = step_rc;
+            break;
+        }
+        // the yield – the only time nothing is locked
+        std::unique_lock<std::mutex> lock(_lock);
+        _wake.wait_for(lock, std::chrono::milliseconds(_yield_ms), [this] { return _cancel; });
+        if(_cancel) {
+            rc = SQLITE_INTERRUPT;
+            break;
+        }
+    }
+
+    if(backup) {
+        int finish_rc = sqlite3_backup_finish(backup);
+        if(rc == SQLITE_DONE && finish_rc != SQLITE_OK) {
+            rc = finish_rc;
+        }
+    }
+    if(rc != SQLITE_DONE && rc != SQLITE_INTERRUPT && dst) {
+        printf("BWBackup %s: %s\n", _dest.c_str(), sqlite3_errstr(rc));
+    }
+    sqlite3_close(dst);
+    if(!_live) {
+        sqlite3_close(src);
+    }
+
+    std::lock_guard<std::mutex> guard(_lock);
+    _progress.elapsed_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    _progress.done = true;
+    _progress.rc = rc;
+}
+
+// the copy runs on a connection of its own, so this is the file's mode
+bool BWBackup::_is_wal(sqlite3 * db) {
+    sqlite3_stmt * stmt = nullptr;
+    bool wal = false;
+    if(db && sqlite3_prepare_v2(db, "PRAGMA journal_mode", -1, &stmt, nullptr) == SQLITE_OK
+       && sqlite3_step(stmt) == SQLITE_ROW) {
+        const char * mode = (const char *) sqlite3_column_text(stmt, 0);
+        wal = mode && !sqlite3_stricmp(mode, "wal");
+    }
+    sqlite3_finalize(stmt);
+    return wal;
+}
+
+}
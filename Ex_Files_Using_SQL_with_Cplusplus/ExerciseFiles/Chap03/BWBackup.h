@@ -0,0 +1,94 @@
+//  BWBackup.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWBACKUP_H
+#define BWBACKUP_H
+
+#include <sqlite3.h>
+#include <sqlcpp.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace bw {
+
+#define DEFAULT_BACKUP_PAGES 64         // pages per sqlite3_backup_step
+#define DEFAULT_BACKUP_YIELD_MS 5       // sleep between steps
+#define DEFAULT_BACKUP_MAX_RESTARTS 8   // then finish in one step
+#define DEFAULT_BACKUP_BUSY_TIMEOUT 5000
+
+struct BWBackupProgress {
+    int total = 0;                  // pages in the source, as of the last step
+    int remaining = 0;
+    int64_t copied = 0;             // every page written, restarts included
+    int steps = 0;
+    int busy = 0;                   // steps that found the source or destination locked
+    int restarts = 0;               // the source changed under us
+    double elapsed_ms = 0;
+    double pages_per_sec = 0;
+    bool done = false;
+    int rc = SQLITE_OK;             // SQLITE_DONE when the copy is complete
+};
+
+// an online backup on its own thread – sqlite3_backup_step a few
+// pages at a time with a sleep between, so no lock is held for long
+// a file is read through its own read-only connection; a write to the
+// source from any other connection makes sqlite start the copy over,
+// and after max_restarts a WAL source is copied in a single step –
+// that step only holds a read transaction, and writers never wait on it
+// a rollback-journal source would hold SHARED for the whole copy and
+// block every writer, so it keeps stepping and restarting instead;
+// under steady writes it finishes only in a lull – use WAL
+// an in-memory source (BWHotCache) is read on its own connection,
+// which must be FULLMUTEX, and its writes are carried into the copy
+// the destination is replaced, and is only changed when the copy commits
+class BWBackup {
+    using clock = std::chrono::steady_clock;
+
+    std::string _source;            // file name, empty for the live connection
+    sqlite3 * _live = nullptr;
+    std::string _dest;
+    int _pages;
+    int _yield_ms;
+    int _max_restarts = DEFAULT_BACKUP_MAX_RESTARTS;
+    std::function<void(const BWBackupProgress &)> _on_progress;
+    BWBackupProgress _progress;
+    bool _cancel = false;
+    std::mutex _lock;
+    std::condition_variable _wake;
+    std::thread _worker;
+
+public:
+    // ctor/dtor
+    BWBackup(sqlite3 * source, const char * dest, int pages = DEFAULT_BACKUP_PAGES,
+             int yield_ms = DEFAULT_BACKUP_YIELD_MS);
+    ~BWBackup();                    // cancels and waits
+
+    // backup methods
+    bool on_progress(std::function<void(const BWBackupProgress &)> f);     // false after start()
+    bool max_restarts(int restarts);                                        // false after start()
+    bool start();
+    int wait();                     // SQLITE_DONE on success
+    void cancel();
+
+    // utilities
+    BWBackupProgress progress();
+    const char * dest() const;
+
+    // rule of five stuff
+    BWBackup(const BWBackup &)                = delete;   // no copy
+    BWBackup & operator = (const BWBackup &)  = delete;   // no assignment
+
+private:
+    void _run();
+    static bool _is_wal(sqlite3 * db);
+};
+
+}
+
+#endif // BWBACKUP_H
@@ -0,0 +1,123 @@
+//  BWBind.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWBIND_H
+#define BWBIND_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace bw {
+
+// a blob parameter or column value
+// the data is not copied, it must outlive the statement
+struct blob {
+    const void * data = nullptr;
+    int size = 0;
+};
+
+// MARK: - bind parameters
+
+// each overload binds one value with the matching sqlite3_bind_* call
+// parameter numbers start at 1
+// strings and blobs are bound SQLITE_STATIC unless dtor says otherwise,
+// so the caller keeps them alive until the statement is reset
+
+inline int bind_param(sqlite3_stmt * stmt, int index, std::nullptr_t,
+                      sqlite3_destructor_type = SQLITE_STATIC) {
+    return sqlite3_bind_null(stmt, index);
+}
+
+template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+inline int bind_param(sqlite3_stmt * stmt, int index, T value,
+                      sqlite3_destructor_type = SQLITE_STATIC) {
+    return sqlite3_bind_int64(stmt, index, (sqlite3_int64) value);
+}
+
+template<typename T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+inline int bind_param(sqlite3_stmt * stmt, int index, T value,
+                      sqlite3_destructor_type = SQLITE_STATIC) {
+    return sqlite3_bind_double(stmt, index, (double) value);
+}
+
+inline int bind_param(sqlite3_stmt * stmt, int index, const char * value,
+                      sqlite3_destructor_type dtor = SQLITE_STATIC) {
+    if(!value) {
+        return sqlite3_bind_null(stmt, index);
+    }
+    return sqlite3_bind_text(stmt, index, value, -1, dtor);
+}
+
+inline int bind_param(sqlite3_stmt * stmt, int index, std::string_view value,
+                      sqlite3_destructor_type dtor = SQLITE_STATIC) {
+    return sqlite3_bind_text(stmt, index, value.data(), (int) value.size(), dtor);
+}
+
+inline int bind_param(sqlite3_stmt * stmt, int index, const std::string & value,
+                      sqlite3_destructor_type dtor = SQLITE_STATIC) {
+    return sqlite3_bind_text(stmt, index, value.data(), (int) value.size(), dtor);
+}
+
+// a temporary string won't outlive the statement, so sqlite gets a copy
+inline int bind_param(sqlite3_stmt * stmt, int index, std::string && value,
+                      sqlite3_destructor_type = SQLITE_STATIC) {
+    return sqlite3_bind_text(stmt, index, value.data(), (int) value.size(), SQLITE_TRANSIENT);
+}
+
+inline int bind_param(sqlite3_stmt * stmt, int index, blob value,
+                      sqlite3_destructor_type dtor = SQLITE_STATIC) {
+    if(!value.data) {
+        return sqlite3_bind_zeroblob(stmt, index, value.size);
+    }
+    return sqlite3_bind_blob(stmt, index, value.data, value.size, dtor);
+}
+
+// bind all args in order, starting at parameter 1
+// returns the first error, or SQLITE_OK
+template<typename... Args>
+inline int bind_params(sqlite3_stmt * stmt, Args &&... args) {
+    (void) stmt;    // unused when there are no args
+    int rc = SQLITE_OK;
+    int index = 0;
+    ((rc = rc ? rc : bind_param(stmt, ++index, std::forward<Args>(args))), ...);
+    return rc;
+}
+
+// MARK: - compile-time parameter count
+
+// counts ? placeholders outside of quoted strings and identifiers
+// numbered (?NNN) and named (:name) parameters are not supported here
+constexpr int sql_param_count(const char * sql) {
+    int count = 0;
+    char quote = 0;
+    for(; *sql; ++sql) {
+        char c = *sql;
+        if(quote) {
+            if(c == quote) quote = 0;
+        } else if(c == '\'' || c == '"' || c == '`') {
+            quote = c;
+        } else if(c == '?') {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// SQL text with its parameter count carried in the type
+// build these with BW_SQL() so the count is checked at compile time
+template<int N>
+struct sql_const {
+    const char * str;
+};
+
+#define BW_SQL(s) (bw::sql_const<bw::sql_param_count(s)>{ (s) })
+
+}
+
+#endif // BWBIND_H
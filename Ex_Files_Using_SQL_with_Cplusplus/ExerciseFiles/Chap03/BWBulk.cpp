@@ -0,0 +1,278 @@
+//  BWBulk.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWBulk.h"
+
+namespace bw {
+
+// MARK: - constructors
+
+BulkLoader::BulkLoader(BWSQL & db, const char * table, const char ** columns, int num_columns)
+: _db(&db), _table(table)
+{
+    for(int index = 0; index < num_columns; ++index) {
+        _columns.emplace_back(columns[index]);
+    }
+    _prepare();
+}
+
+BulkLoader::BulkLoader(BWCRUD & crud)
+: _db(&crud)
+{
+    const char ** col_names = crud.col_names();
+    if(!col_names) {
+        puts("BulkLoader: no table or column names");
+        return;
+    }
+    _table = crud.table_name();
+
+    // skip the id column (it's always the first col)
+    for(int index = 1; index < crud.col_count(); ++index) {
+        _columns.emplace_back(col_names[index]);
+    }
+    _prepare();
+}
+
+// commits whatever is left
+BulkLoader::~BulkLoader() {
+    finish();
+}
+
+// MARK: - bulk methods
+
+// flushes the last partial batch and commits
+void BulkLoader::finish() {
+    _flush();
+    if(_in_txn) {
+        _commit();
+    }
+}
+
+// MARK: - utilities
+
+// rows or ms <= 0 turns that limit off
+void BulkLoader::commit_every(int rows, int ms) {
+    _commit_rows = rows;
+    _commit_ms = ms;
+}
+
+// K is the largest row count that fits SQLITE_LIMIT_VARIABLE_NUMBER,
+// capped at max_rows
+void BulkLoader::multi_row(bool on, int max_rows) {
+    _flush();
+    _batch = Statement();
+    _pending.clear();
+    _batch_rows = 1;
+    if(!on || _columns.empty()) {
+        return;
+    }
+    int max_vars = sqlite3_limit(_db->db(), SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+    int rows = max_vars / (int) _columns.size();
+    if(max_rows > 0 && rows > max_rows) {
+        rows = max_rows;
+    }
+    if(rows < 2) {
+        return;
+    }
+    std::string sql = _build_sql(rows);
+    _batch = Statement(*_db, sql.c_str());
+    if(!_batch) {
+        return;
+    }
+    _batch_rows = rows;
+    _pending.resize((size_t) rows * _columns.size());
+}
+
+int BulkLoader::batch_rows() const {
+    return _batch_rows;
+}
+
+BulkStats BulkLoader::stats() const {
+    BulkStats s = _stats;
+    if(_started) {
+        s.elapsed_ms = std::chrono::duration<double, std::milli>(clock::now() - _start).count();
+    }
+    if(s.elapsed_ms > 0) {
+        s.rows_per_second = (double) s.rows * 1000.0 / s.elapsed_ms;
+    }
+    return s;
+}
+
+const char * BulkLoader::table() const {
+    return _table.c_str();
+}
+
+int BulkLoader::num_columns() const {
+    return (int) _columns.size();
+}
+
+// MARK: - private
+
+void BulkLoader::_prepare() {
+    if(_table.empty() || _columns.empty()) {
+        return;
+    }
+    std::string sql = _build_sql(1);
+    _insert = Statement(*_db, sql.c_str());
+}
+
+// INSERT INTO table (a,b,c) VALUES (?,?,?),(?,?,?) ... for rows rows
+std::string BulkLoader::_build_sql(int rows) const {
+    sqlite3_str * s_str = sqlite3_str_new(_db->db());
+    sqlite3_str_appendf(s_str, "INSERT INTO %s (", _table.c_str());
+    for(size_t index = 0; index < _columns.size(); ++index) {
+        sqlite3_str_appendf(s_str, "%s%s", index ? "," : "", _columns[index].c_str());
+    }
+    sqlite3_str_appendall(s_str, ") VALUES ");
+    for(int row = 0; row < rows; ++row) {
+        sqlite3_str_appendall(s_str, row ? ",(" : "(");
+        for(size_t index = 0; index < _columns.size(); ++index) {
+            sqlite3_str_appendall(s_str, index ? ",?" : "?");
+        }
+        sqlite3_str_appendall(s_str, ")");
+    }
+    std::string sql;
+    char * str = sqlite3_str_finish(s_str);
+    if(str) {
+        sql = str;
+        sqlite3_free(str);
+    }
+    return sql;
+}
+
+// opens a chunk transaction, unless the caller already has one
+void BulkLoader::_begin_row() {
+    if(!_started) {
+        _started = true;
+        _start = clock::now();
+    }
+    if(!_in_txn && sqlite3_get_autocommit(_db->db())) {
+        // without it each row commits on its own – slow, but nothing is lost
+        if(sqlite3_exec(_db->db(), "BEGIN", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            printf("BulkLoader: BEGIN: %s\n", sqlite3_errmsg(_db->db()));
+            return;
+        }
+        _in_txn = true;
+        _txn_rows = 0;
+        _txn_loaded = 0;
+        _txn_start = clock::now();
+    }
+}
+
+void BulkLoader::_end_rows(int rows, bool ok) {
+    ++_stats.statements;
+    if(ok) {
+        _stats.rows += rows;
+        if(_in_txn) {
+            _txn_loaded += rows;
+        }
+    } else {
+        _stats.failed += rows;
+        printf("BulkLoader: %s\n", sqlite3_errmsg(_db->db()));
+        _check_rollback();
+    }
+    if(!_in_txn) {
+        return;
+    }
+    _txn_rows += rows;
+    if(_commit_rows > 0 && _txn_rows >= _commit_rows) {
+        _commit();
+    } else if(_commit_ms > 0 &&
+              std::chrono::duration<double, std::milli>(clock::now() - _txn_start).count() >= _commit_ms) {
+        _commit();
+    }
+}
+
+// runs the pending rows through the K row statement,
+// or through a tail statement for a partial batch
+// a batch that fails goes again through the single row INSERT
+void BulkLoader::_flush() {
+    if(!_pending_rows) {
+        return;
+    }
+    int rows = _pending_rows;
+    _pending_rows = 0;
+    Statement tail;
+    Statement * st = &_batch;
+    if(rows < _batch_rows) {
+        std::string sql = _build_sql(rows);
+        tail = Statement(*_db, sql.c_str());
+        st = &tail;
+    }
+
+    bool ok = st->valid();
+    if(ok) {
+        sqlite3_stmt * stmt = st->stmt();
+        sqlite3_reset(stmt);
+        int num_values = rows * (int) _columns.size();
+        for(int index = 0; ok && index < num_values; ++index) {
+            ok = bind_param(stmt, index + 1, _pending[index]) == SQLITE_OK;
+        }
+        ok = ok && st->step() == SQLITE_DONE;
+        st->reset();
+    }
+    if(ok) {
+        _end_rows(rows, true);
+        return;
+    }
+
+    // the statement failed as a whole – unless sqlite rolled back the
+    // transaction too, it left nothing behind
+    // one row at a time, so only the bad row is lost
+    _check_rollback();
+    for(int row = 0; row < rows; ++row) {
+        _begin_row();
+        sqlite3_stmt * stmt = _insert.stmt();
+        bool row_ok = stmt != nullptr;
+        for(size_t col = 0; row_ok && col < _columns.size(); ++col) {
+            row_ok = bind_param(stmt, (int) col + 1, _pending[(size_t) row * _columns.size() + col]) == SQLITE_OK;
+        }
+        row_ok = row_ok && _insert.step() == SQLITE_DONE;
+        _insert.reset();
+        _end_rows(1, row_ok);
+    }
+}
+
+// some errors (FULL, IOERR, NOMEM, ON CONFLICT ROLLBACK) make sqlite
+// roll back the whole transaction – its rows are lost, and the next
+// row opens a new one
+void BulkLoader::_check_rollback() {
+    if(!_in_txn || !sqlite3_get_autocommit(_db->db())) {
+        return;
+    }
+    if(_txn_loaded) {
+        printf("BulkLoader: transaction rolled back, %d rows lost\n", _txn_loaded);
+    }
+    _stats.rows -= (uint64_t) _txn_loaded;
+    _stats.failed += (uint64_t) _txn_loaded;
+    _in_txn = false;
+    _txn_rows = 0;
+    _txn_loaded = 0;
+}
+
+// a COMMIT that fails leaves the transaction open – after the retries
+// it's rolled back, or every later row would go into it and be lost
+bool BulkLoader::_commit() {
+    int rc = sqlite3_exec(_db->db(), "COMMIT", nullptr, nullptr, nullptr);
+    for(int retry = 0; rc == SQLITE_BUSY && retry < DEFAULT_BULK_COMMIT_RETRIES; ++retry) {
+        sqlite3_sleep(10);
+        rc = sqlite3_exec(_db->db(), "COMMIT", nullptr, nullptr, nullptr);
+    }
+    if(rc != SQLITE_OK) {
+        printf("BulkLoader: COMMIT: %s, %d rows rolled back\n", sqlite3_errmsg(_db->db()), _txn_loaded);
+        if(!sqlite3_get_autocommit(_db->db())) {
+            sqlite3_exec(_db->db(), "ROLLBACK", nullptr, nullptr, nullptr);
+        }
+        _stats.rows -= (uint64_t) _txn_loaded;
+        _stats.failed += (uint64_t) _txn_loaded;
+    } else {
+        ++_stats.commits;
+    }
+    _in_txn = false;
+    _txn_rows = 0;
+    _txn_loaded = 0;
+    return rc == SQLITE_OK;
+}
+
+}
@@ -0,0 +1,143 @@
+//  BWBulk.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWBULK_H
+#define BWBULK_H
+
+#include "BWCRUD.h"
+#include "BWValue.h"
+#include <chrono>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace bw {
+
+#define DEFAULT_BULK_COMMIT_ROWS 10000
+#define DEFAULT_BULK_COMMIT_MS 1000
+#define DEFAULT_BULK_MAX_BATCH_ROWS 500
+#define DEFAULT_BULK_COMMIT_RETRIES 3      // a busy COMMIT is tried this many more times
+
+struct BulkStats {
+    uint64_t rows = 0;
+    uint64_t failed = 0;
+    uint64_t commits = 0;
+    uint64_t statements = 0;    // INSERTs executed, less than rows when batching
+    double elapsed_ms = 0;
+    double rows_per_second = 0;
+};
+
+// bulk INSERT into one table
+// the INSERT is prepared once and rebound for each row
+// rows go in chunked transactions, committed every N rows or M ms,
+// unless the caller already has a transaction open
+// a COMMIT that fails is retried, then rolled back – its rows count as failed
+// in multi-row mode, K rows go in each INSERT ... VALUES (...),(...)
+class BulkLoader {
+    using clock = std::chrono::steady_clock;
+
+    BWSQL * _db = nullptr;
+    std::string _table;
+    std::vector<std::string> _columns;
+    Statement _insert;
+    Statement _batch;           // K rows per statement
+    int _batch_rows = 1;        // K
+    std::vector<Value> _pending;
+    int _pending_rows = 0;
+    int _commit_rows = DEFAULT_BULK_COMMIT_ROWS;
+    int _commit_ms = DEFAULT_BULK_COMMIT_MS;
+    bool _in_txn = false;       // we own an open transaction
+    int _txn_rows = 0;
+    int _txn_loaded = 0;        // rows lost if the COMMIT fails
+    clock::time_point _txn_start;
+    clock::time_point _start;
+    bool _started = false;
+    BulkStats _stats;
+
+public:
+    // ctor/dtor
+    BulkLoader(BWSQL & db, const char * table, const char ** columns, int num_columns);
+    BulkLoader(BWCRUD & crud);      // all columns of the current table except id
+    ~BulkLoader();
+
+    // bulk methods
+    template<typename... Args> bool add(Args &&... args);
+    template<typename Range> uint64_t load(const Range & rows);
+    template<typename Producer> uint64_t load_from(Producer && producer);
+    void finish();
+
+    // utilities
+    void commit_every(int rows, int ms);
+    void multi_row(bool on, int max_rows = DEFAULT_BULK_MAX_BATCH_ROWS);
+    int batch_rows() const;
+    BulkStats stats() const;
+    const char * table() const;
+    int num_columns() const;
+
+    // rule of five stuff
+    BulkLoader(const BulkLoader &)                = delete;   // no copy
+    BulkLoader & operator = (const BulkLoader &)  = delete;   // no assignment
+
+private:
+    void _prepare();
+    std::string _build_sql(int rows) const;
+    void _begin_row();
+    void _end_rows(int rows, bool ok);
+    void _flush();
+    void _check_rollback();
+    bool _commit();
+};
+
+// one row, one value per column
+template<typename... Args>
+bool BulkLoader::add(Args &&... args) {
+    _begin_row();
+    if(_batch_rows > 1) {
+        // copy the row into the pending batch
+        if((int) sizeof...(Args) != num_columns()) {
+            printf("BulkLoader: %d columns expected, %d given\n", num_columns(), (int) sizeof...(Args));
+            ++_stats.failed;
+            return false;
+        }
+        size_t index = (size_t) _pending_rows * _columns.size();
+        ((_pending[index++].set(std::forward<Args>(args))), ...);
+        if(++_pending_rows == _batch_rows) {
+            _flush();
+        }
+        return true;
+    }
+    bool ok = _insert.bind(std::forward<Args>(args)...) && _insert.step() == SQLITE_DONE;
+    _insert.reset();
+    _end_rows(1, ok);
+    return ok;
+}
+
+// a range of tuples (or pairs), one per row
+// returns the rows this call loaded – pending rows are flushed
+// on the way in and on the way out, so none are miscounted
+template<typename Range>
+uint64_t BulkLoader::load(const Range & rows) {
+    _flush();
+    uint64_t before = _stats.rows;
+    for(const auto & row : rows) {
+        std::apply([this](const auto &... values) { add(values...); }, row);
+    }
+    _flush();
+    return _stats.rows - before;
+}
+
+// producer(BulkLoader &) calls add() for the next row
+// and returns false when there are no more rows
+template<typename Producer>
+uint64_t BulkLoader::load_from(Producer && producer) {
+    _flush();
+    uint64_t before = _stats.rows;
+    while(producer(*this)) {}
+    _flush();
+    return _stats.rows - before;
+}
+
+}
+
+#endif // BWBULK_H
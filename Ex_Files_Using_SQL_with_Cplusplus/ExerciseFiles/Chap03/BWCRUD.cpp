@@ -8,15 +8,12 @@ namespace bw {
 
 // MARK: - constructors
 
-BWCRUD::BWCRUD(const char * filename, const char * tablename)
-: BWSQL(filename)
+// the default profile is WAL, so readers on other connections
+// work alongside writers – sqlite.org/wal.html
+BWCRUD::BWCRUD(const char * filename, const char * tablename, const OpenProfile & profile)
+: BWSQL(filename, profile)
 {
     _db = db();
-    init_sec_db();
-
-    // WAL mode allows sec_db read access to open tables
-    // sqlite.org/wal.html
-    sql_do("PRAGMA journal_mode=WAL");
 
     if(tablename) {
         _reset_table_name();
@@ -26,9 +23,8 @@ BWCRUD::BWCRUD(const char * filename, const char * tablename)
     return;
 }
 
-void BWCRUD::init_sec_db() {
-    static BWSQL sec_db(filename());
-    _sec_db = & sec_db;
+BWCRUD::~BWCRUD() {
+    _reset_table_name();
 }
 
 // MARK: - CRUD methods
@@ -36,12 +32,13 @@ void BWCRUD::init_sec_db() {
 // va_list requires one named argument
 // so it's called none – it's ignored just give it a zero
 int BWCRUD::insert(int none, ...) {
+    BW_TRACE_OP("insert");
     const char * buf = nullptr;
     if(!_table_name or !col_names()) {
         puts("insert: no table or column names");
         return 0;
     }
-    char * sql = new char [MAX_SMALL_STRING_LENGTH];
+    char * sql = arena().alloc_array<char>(MAX_SMALL_STRING_LENGTH);
     memset((void *) sql, 0, MAX_SMALL_STRING_LENGTH);
 
     const char * col_names = columns_string();
@@ -61,26 +58,29 @@ int BWCRUD::insert(int none, ...) {
     va_start(ap, none);
     _sql_prepare(sql, ap);
     va_end(ap);
-    sqlite3_step(stmt());
+    _step();
 
-    delete [] sql;
+    arena().dealloc_array(sql, MAX_SMALL_STRING_LENGTH);
     return sqlite3_changes(db());
 }
 
 // returns column count of prepared statement
 int BWCRUD::get_rows() {
+    BW_TRACE_OP("get_rows");
     const char * sql = _build_query("SELECT * FROM %s");
     return sql_prepare(sql);
 }
 
+// id is bound as an integer so the primary key index is used
 const char ** BWCRUD::get_row(int id) {
-    char idstr[MAX_TINY_STRING_LENGTH];
-    find_rows("id", bw_itoa(id, idstr));
+    BW_TRACE_OP("get_row");
+    sql_prepare(_build_query("SELECT * FROM %s WHERE id = ?"), id);
     return fetch_row();
 }
 
 // returns column count of prepared statement
 int BWCRUD::find_rows(const char * col, const char * value) {
+    BW_TRACE_OP("find_rows");
     char sql[MAX_SMALL_STRING_LENGTH];
     memset((void *) sql, 0, MAX_SMALL_STRING_LENGTH);
     sqlite3_snprintf(MAX_SMALL_STRING_LENGTH, sql,
@@ -91,23 +91,27 @@ int BWCRUD::find_rows(const char * col, const char * value) {
 
 // returns first row in result
 const char ** BWCRUD::find_row(const char * col, const char * value) {
+    BW_TRACE_OP("find_row");
     find_rows(col, value);
     return fetch_row();
 }
 
 // returns id of first row in result
 int BWCRUD::find_row_id(const char * col, const char * value) {
+    BW_TRACE_OP("find_row_id");
     find_rows(col, value);
-    return atoi(fetch_row()[0]);
+    RowView row = fetch_view();
+    return row ? (int) row.get<int64_t>(0) : 0;
 }
 
 int BWCRUD::update_row(int row_id, ...) {
+    BW_TRACE_OP("update_row");
     size_t buflen = 0;
     if(!_table_name or !col_names()) {
         puts("insert: no table or column names");
         return 0;
     }
-    char * sql = new char [MAX_SMALL_STRING_LENGTH];
+    char * sql = arena().alloc_array<char>(MAX_SMALL_STRING_LENGTH);
     memset((void *) sql, 0, MAX_SMALL_STRING_LENGTH);
 
     // build the convoluted update string
@@ -118,6 +122,7 @@ int BWCRUD::update_row(int row_id, ...) {
     // {column} = ?, {column} = ?, [...]
     for(int i = 1; i < _col_count; ++i) {
         if(buflen >= MAX_SMALL_STRING_LENGTH - 64){
+            arena().dealloc_array(sql, MAX_SMALL_STRING_LENGTH);
             return 0;   // query too long for buffer
         }
         sqlite3_snprintf(MAX_SMALL_STRING_LENGTH - (int) buflen, sql + buflen, "%s = ?%s",
@@ -128,6 +133,7 @@ int BWCRUD::update_row(int row_id, ...) {
 
     // keep checking buflen - important!
     if(buflen >= MAX_SMALL_STRING_LENGTH - 64){
+        arena().dealloc_array(sql, MAX_SMALL_STRING_LENGTH);
         return 0;   // query too long for buffer
     }
 
@@ -139,48 +145,52 @@ int BWCRUD::update_row(int row_id, ...) {
     va_start(ap, row_id);
     _sql_prepare(sql, ap);
     va_end(ap);
-    sqlite3_step(stmt());
+    _step();
+
+    arena().dealloc_array(sql, MAX_SMALL_STRING_LENGTH);
     return sqlite3_changes(db());
 }
 
 int BWCRUD::delete_row(int id) {
-    char idstr[MAX_TINY_STRING_LENGTH];
-    find_rows("id", bw_itoa(id, idstr));
-    sql_do(_build_query("DELETE FROM %s WHERE id = ?"), bw_itoa(id, idstr));
+    BW_TRACE_OP("delete_row");
+    sql_do(_build_query("DELETE FROM %s WHERE id = ?"), id);
     return sqlite3_changes(db());
 }
 
 void BWCRUD::begin() {
+    BW_TRACE_OP("begin");
     sql_do("BEGIN");
 }
 
 void BWCRUD::commit() {
+    BW_TRACE_OP("commit");
     sql_do("COMMIT");
     reset_stmt();
 }
 
 int BWCRUD::count_rows() {
-    // use the sec database so we don't interfere with an ongoing statement
-    const char * cc = _sec_db->sql_value(_build_query("SELECT COUNT(*) FROM %s"));
-    if(cc) {
-        return atoi(cc);
-    } else {
-        return 0;
-    }
+    BW_TRACE_OP("count_rows");
+    // use a separate statement so we don't interfere with an ongoing statement
+    Statement st(*this, _build_query("SELECT COUNT(*) FROM %s"));
+    RowView row = st.fetch_view();
+    return row ? (int) row.get<int64_t>(0) : 0;
 }
 
 int BWCRUD::col_count() {
-    // use the sec database so we don't interfere with an ongoing statement
+    BW_TRACE_OP("col_count");
+    // use a separate statement so we don't interfere with an ongoing statement
     if(_table_name && !_col_count) {
-        const char * cc = _sec_db->sql_value(_build_query("SELECT COUNT(*) FROM pragma_table_info('%s');"));
-        if(cc) {
-            _col_count = atoi(cc);
+        Statement st(*this, _build_query("SELECT COUNT(*) FROM pragma_table_info('%s');"));
+        RowView row = st.fetch_view();
+        if(row) {
+            _col_count = (int) row.get<int64_t>(0);
         }
     }
     return _col_count;
 }
 
 const char ** BWCRUD::col_names(){
+    BW_TRACE_OP("col_names");
     if(!_table_name) {
         return nullptr;
     }
@@ -188,26 +198,26 @@ const char ** BWCRUD::col_names(){
         col_count();
     }
     if(!_col_names) {
-        // we need space for both pointers and storage
-        // this is freed from the destructor
-        _col_names = new const char * [_col_count];
-        _col_names_buf = new char [_col_count * MAX_SMALL_STRING_LENGTH];
+        // pointers and names both come from the connection's arena
+        // they go back in _reset_table_name()
+        _col_names = arena().alloc_array<const char *>(_col_count);
         memset((void *) _col_names, 0, _col_count * sizeof(const char *));
-        memset((void *) _col_names_buf, 0, _col_count * MAX_SMALL_STRING_LENGTH);
 
-        // use the sec database so we don't interfere with an ongoing statement
-        _sec_db->sql_prepare(_build_query("SELECT name FROM pragma_table_info('%s');"));
+        // use a separate statement so we don't interfere with an ongoing statement
+        Statement st(*this, _build_query("SELECT name FROM pragma_table_info('%s');"));
 
         for(int i = 0; i < _col_count; ++i) {
-            const char ** row = _sec_db->fetch_row();
+            const char ** row = st.fetch_row();
             if(row && row[0]) {
                 if(i == 0 && !(row[0][0] == 'i' && row[0][1] == 'd' && row[0][2] == 0)) {
                     this->_reset_table_name();
                     puts("col_names: first column must be id");
                     exit(0);
                 }
-                const char * v = _col_names_buf + (i * MAX_SMALL_STRING_LENGTH);
-                memcpy((void *)v, (const void *) row[0], strnlen(row[0], MAX_SMALL_STRING_LENGTH));
+                size_t len = strnlen(row[0], MAX_SMALL_STRING_LENGTH - 1);
+                char * v = arena().alloc_array<char>(len + 1);
+                memcpy((void *) v, (const void *) row[0], len);
+                v[len] = 0;
                 _col_names[i] = v;
             }
         }
@@ -217,16 +227,18 @@ const char ** BWCRUD::col_names(){
 }
 
 bool BWCRUD::have_table(const char * name) {
+    BW_TRACE_OP("have_table");
     if(!name) {
         name = _table_name;
     }
 
-    // use the sec database so we don't interfere with an ongoing statement
-    const char * rc = _sec_db->sql_value("SELECT name FROM sqlite_master WHERE type = 'table' AND name = ?", name);
-    return rc ? true : false;
+    // use a separate statement so we don't interfere with an ongoing statement
+    Statement st = statement("SELECT name FROM sqlite_master WHERE type = 'table' AND name = ?", name);
+    return st.fetch_view() ? true : false;
 }
 
 int BWCRUD::drop_table() {
+    BW_TRACE_OP("drop_table");
     return sql_do(_build_query("DROP TABLE IF EXISTS %s"));
 }
 
@@ -263,7 +275,7 @@ const char * BWCRUD::cstring_join(int count, const char * sep, ...) {
         }
     }
     memcpy((void *) cstr, sqlite3_str_value(s_str), len);
-    sqlite3_str_finish(s_str);
+    sqlite3_free(sqlite3_str_finish(s_str));
     va_end(ap);
     return cstr;
 }
@@ -295,7 +307,7 @@ const char * BWCRUD::cstring_join(int count, const char * sep, const char ** str
         }
     }
     memcpy((void *) cstr, sqlite3_str_value(s_str), len);
-    sqlite3_str_finish(s_str);
+    sqlite3_free(sqlite3_str_finish(s_str));
     return cstr;
 }
 
@@ -323,7 +335,7 @@ const char * BWCRUD::cstring_multiply(int count, const char * sep, const char *
         }
     }
     memcpy((void *) cstr, sqlite3_str_value(s_str), len);
-    sqlite3_str_finish(s_str);
+    sqlite3_free(sqlite3_str_finish(s_str));
     return cstr;
 }
 
@@ -388,13 +400,14 @@ const char * BWCRUD::_build_query(const char * qstr) {
 void BWCRUD::_reset_table_name() {
     _table_name = nullptr;
     if(_col_names) {
-        delete [] _col_names;
+        for(int i = 0; i < _col_count; ++i) {
+            if(_col_names[i]) {
+                arena().dealloc_array(_col_names[i], strlen(_col_names[i]) + 1);
+            }
+        }
+        arena().dealloc_array(_col_names, _col_count);
         _col_names = nullptr;
     }
-    if(_col_names_buf) {
-        delete [] _col_names_buf;
-        _col_names_buf = nullptr;
-    }
     _col_count = 0;
 }
 
@@ -13,15 +13,15 @@ namespace bw {
 
 class BWCRUD : public BWSQL {
     sqlite3 * _db;
-    BWSQL * _sec_db = nullptr;   // for secondary queries
-    const char * _table_name;
-    const char ** _col_names;
-    const char * _col_names_buf;
-    int _col_count;
+    const char * _table_name = nullptr;
+    const char ** _col_names = nullptr;
+    int _col_count = 0;
 
 public:
     // ctor/dtor
-    BWCRUD(const char * filename, const char * tablename = nullptr);
+    BWCRUD(const char * filename, const char * tablename = nullptr,
+           const OpenProfile & profile = profile_wal);
+    ~BWCRUD();
 
     // CRUD
     int insert(int zero, ...);
@@ -57,8 +57,7 @@ public:
 private:
     const char * _build_query(const char *);
     void _reset_table_name();
-    void init_sec_db();
-    
+
 };
 
 }
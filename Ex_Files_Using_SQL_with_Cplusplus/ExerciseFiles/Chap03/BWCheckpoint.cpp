@@ -0,0 +1,250 @@
+//  BWCheckpoint.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWCheckpoint.h"
+#include "BWSQL.h"
+#include <filesystem>
+
+namespace bw {
+
+// sqlite's SQLITE_DEFAULT_WAL_AUTOCHECKPOINT, put back by remove()
+constexpr int default_autocheckpoint = 1000;
+
+static int64_t wal_file_size(const std::string & filename) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(filename + "-wal", ec);
+    return ec ? 0 : (int64_t) size;
+}
+
+BWCheckpointer::File::~File() {
+    if(ckpt_db) {
+        sqlite3_close(ckpt_db);
+    }
+}
+
+// MARK: - constructors
+
+BWCheckpointer::BWCheckpointer(int idle_ms, int restart_pages, int truncate_pages, int interval_ms)
+: _interval_ms(interval_ms > 0 ? interval_ms : DEFAULT_CKPT_INTERVAL_MS),
+  _idle_ms(idle_ms >= 0 ? idle_ms : DEFAULT_CKPT_IDLE_MS),
+  _restart_pages(restart_pages > 0 ? restart_pages : DEFAULT_CKPT_RESTART_PAGES),
+  _truncate_pages(truncate_pages > 0 ? truncate_pages : DEFAULT_CKPT_TRUNCATE_PAGES)
+{
+    _worker = std::thread(&BWCheckpointer::_run, this);
+}
+
+// anything still registered gets its autocheckpoint back
+BWCheckpointer::~BWCheckpointer() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stop = true;
+    }
+    _wake.notify_one();
+    if(_worker.joinable()) {
+        _worker.join();
+    }
+    for(auto & entry : _files) {
+        for(sqlite3 * db : entry.second->conns) {
+            sqlite3_wal_hook(db, nullptr, nullptr);
+            sqlite3_wal_autocheckpoint(db, default_autocheckpoint);
+        }
+    }
+}
+
+// MARK: - checkpoint methods
+
+bool BWCheckpointer::add(BWSQL & db) {
+    return add(db.db());
+}
+
+// the database must already be in WAL mode
+bool BWCheckpointer::add(sqlite3 * db) {
+    const char * filename = db ? sqlite3_db_filename(db, "main") : nullptr;
+    if(!filename || !*filename) {
+        printf("BWCheckpointer: not a file database\n");
+        return false;
+    }
+    sqlite3_stmt * stmt = nullptr;
+    bool wal = false;
+    if(sqlite3_prepare_v2(db, "PRAGMA journal_mode", -1, &stmt, nullptr) == SQLITE_OK
+       && sqlite3_step(stmt) == SQLITE_ROW) {
+        const char * mode = (const char *) sqlite3_column_text(stmt, 0);
+        wal = mode && !sqlite3_stricmp(mode, "wal");
+    }
+    sqlite3_finalize(stmt);
+    if(!wal) {
+        printf("BWCheckpointer: %s is not in WAL mode\n", filename);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(_lock);
+    std::shared_ptr<File> & f = _files[filename];
+    if(!f) {
+        f = std::make_shared<File>();
+        f->filename = filename;
+        if(sqlite3_open_v2(filename, &f->ckpt_db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_FULLMUTEX, nullptr) != SQLITE_OK) {
+            printf("BWCheckpointer: %s: %s\n", filename, sqlite3_errmsg(f->ckpt_db));
+            _files.erase(filename);
+            return false;
+        }
+        sqlite3_busy_timeout(f->ckpt_db, DEFAULT_CKPT_BUSY_TIMEOUT);
+        // a connection that hasn't read the database isn't in WAL mode yet,
+        // and its checkpoints do nothing
+        sqlite3_exec(f->ckpt_db, "PRAGMA journal_mode", nullptr, nullptr, nullptr);
+        f->stats.filename = filename;
+    }
+    for(sqlite3 * c : f->conns) {
+        if(c == db) {
+            return true;
+        }
+    }
+    f->conns.push_back(db);
+    sqlite3_wal_hook(db, _wal_hook, f.get());
+    return true;
+}
+
+void BWCheckpointer::remove(BWSQL & db) {
+    remove(db.db());
+}
+
+void BWCheckpointer::remove(sqlite3 * db) {
+    std::lock_guard<std::mutex> guard(_lock);
+    for(auto it = _files.begin(); it != _files.end(); ++it) {
+        std::vector<sqlite3 *> & conns = it->second->conns;
+        for(auto c = conns.begin(); c != conns.end(); ++c) {
+            if(*c != db) {
+                continue;
+            }
+            // once wal_hook returns, no call to the old hook is in flight
+            sqlite3_wal_hook(db, nullptr, nullptr);
+            sqlite3_wal_autocheckpoint(db, default_autocheckpoint);
+            conns.erase(c);
+            if(conns.empty()) {
+                _files.erase(it);
+            }
+            return;
+        }
+    }
+}
+
+void BWCheckpointer::checkpoint_now(int mode) {
+    std::vector<std::shared_ptr<File>> files;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        for(auto & entry : _files) {
+            files.push_back(entry.second);
+        }
+    }
+    for(auto & f : files) {
+        _checkpoint(*f, mode);
+    }
+}
+
+// MARK: - utilities
+
+std::vector<BWCheckpointStats> BWCheckpointer::stats() {
+    std::vector<BWCheckpointStats> all;
+    std::lock_guard<std::mutex> guard(_lock);
+    for(auto & entry : _files) {
+        File & f = *entry.second;
+        BWCheckpointStats s;
+        {
+            std::lock_guard<std::mutex> stats_guard(f.stats_lock);
+            s = f.stats;
+        }
+        s.connections = (int) f.conns.size();
+        s.wal_pages = f.wal_pages.load(std::memory_order_relaxed);
+        s.wal_pages_max = f.wal_pages_max.load(std::memory_order_relaxed);
+        s.wal_bytes = wal_file_size(f.filename);
+        s.wal_bytes_max = std::max(s.wal_bytes_max, s.wal_bytes);
+        all.push_back(std::move(s));
+    }
+    return all;
+}
+
+// MARK: - private
+
+// runs on the writer's thread, after every commit – keep it short
+int BWCheckpointer::_wal_hook(void * ctx, sqlite3 *, const char * name, int pages) {
+    if(strcmp(name, "main")) {
+        return SQLITE_OK;
+    }
+    File * f = (File *) ctx;
+    f->wal_pages.store(pages, std::memory_order_relaxed);
+    f->last_commit_ns.store(_now_ns(), std::memory_order_relaxed);
+    int max = f->wal_pages_max.load(std::memory_order_relaxed);
+    while(pages > max && !f->wal_pages_max.compare_exchange_weak(max, pages, std::memory_order_relaxed)) {}
+    return SQLITE_OK;
+}
+
+// the biggest WAL is dealt with first, whatever the activity;
+// otherwise a database waits until it has gone quiet
+void BWCheckpointer::_run() {
+    std::unique_lock<std::mutex> lock(_lock);
+    while(!_stop) {
+        _wake.wait_for(lock, std::chrono::milliseconds(_interval_ms), [this] { return _stop; });
+        if(_stop) {
+            break;
+        }
+        std::vector<std::shared_ptr<File>> files;
+        for(auto & entry : _files) {
+            files.push_back(entry.second);
+        }
+        lock.unlock();
+
+        int64_t now = _now_ns();
+        for(auto & f : files) {
+            int pages = f->wal_pages.load(std::memory_order_relaxed);
+            int64_t idle_ns = now - f->last_commit_ns.load(std::memory_order_relaxed);
+            if(pages >= _restart_pages) {
+                if(_checkpoint(*f, SQLITE_CHECKPOINT_PASSIVE)) {
+                    _checkpoint(*f, pages >= _truncate_pages ? SQLITE_CHECKPOINT_TRUNCATE
+                                                             : SQLITE_CHECKPOINT_RESTART);
+                }
+            } else if(pages > 0 && idle_ns >= (int64_t) _idle_ms * 1000000) {
+                _checkpoint(*f, SQLITE_CHECKPOINT_PASSIVE);
+            }
+        }
+        lock.lock();
+    }
+}
+
+// true if every frame in the WAL made it to the database
+// a commit that lands while the checkpoint runs keeps its own count
+bool BWCheckpointer::_checkpoint(File & f, int mode) {
+    int before = f.wal_pages.load(std::memory_order_relaxed);
+    clock::time_point start = clock::now();
+    int log = 0;
+    int done = 0;
+    int rc = sqlite3_wal_checkpoint_v2(f.ckpt_db, "main", mode, &log, &done);
+    double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    if(rc == SQLITE_OK || rc == SQLITE_BUSY) {
+        f.wal_pages.compare_exchange_strong(before, std::max(log - done, 0), std::memory_order_relaxed);
+    }
+
+    int64_t wal_bytes = wal_file_size(f.filename);
+    std::lock_guard<std::mutex> guard(f.stats_lock);
+    switch(mode) {
+        case SQLITE_CHECKPOINT_PASSIVE: ++f.stats.passive; break;
+        case SQLITE_CHECKPOINT_RESTART: ++f.stats.restart; break;
+        default: ++f.stats.truncate; break;
+    }
+    bool complete = rc == SQLITE_OK && done >= log;
+    if(rc == SQLITE_BUSY || (rc == SQLITE_OK && !complete)) {
+        ++f.stats.busy;
+    } else if(rc != SQLITE_OK) {
+        printf("BWCheckpointer: %s: %s\n", f.filename.c_str(), sqlite3_errmsg(f.ckpt_db));
+    }
+    f.stats.last_ms = ms;
+    f.stats.max_ms = std::max(f.stats.max_ms, ms);
+    f.stats.total_ms += ms;
+    f.stats.wal_bytes_max = std::max(f.stats.wal_bytes_max, wal_bytes);
+    return complete;
+}
+
+int64_t BWCheckpointer::_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+}
+
+}
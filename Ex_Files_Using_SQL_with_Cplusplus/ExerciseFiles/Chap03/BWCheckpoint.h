@@ -0,0 +1,113 @@
+//  BWCheckpoint.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWCHECKPOINT_H
+#define BWCHECKPOINT_H
+
+#include <sqlite3.h>
+#include <sqlcpp.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bw {
+
+class BWSQL;
+
+#define DEFAULT_CKPT_INTERVAL_MS 100        // how often the WALs are looked at
+#define DEFAULT_CKPT_IDLE_MS 250            // no commits this long – PASSIVE
+#define DEFAULT_CKPT_RESTART_PAGES 4000     // WAL frames before RESTART
+#define DEFAULT_CKPT_TRUNCATE_PAGES 16000   // WAL frames before TRUNCATE
+#define DEFAULT_CKPT_BUSY_TIMEOUT 100       // RESTART/TRUNCATE wait this long for readers
+
+struct BWCheckpointStats {
+    std::string filename;
+    int connections = 0;
+    int wal_pages = 0;              // frames in the WAL at the last commit, or left by a checkpoint
+    int wal_pages_max = 0;
+    int64_t wal_bytes = 0;          // size of the -wal file now
+    int64_t wal_bytes_max = 0;
+    uint64_t passive = 0;
+    uint64_t restart = 0;
+    uint64_t truncate = 0;
+    uint64_t busy = 0;              // checkpoints that couldn't finish for readers
+    double last_ms = 0;
+    double max_ms = 0;
+    double total_ms = 0;
+};
+
+// checkpoints WAL databases on a thread of its own
+// a registered connection gets a wal_hook, which turns off its
+// autocheckpoint – commits no longer pay for checkpoints inline
+// the hook records the WAL size and the time, and the thread runs
+// PASSIVE when a database has gone idle, RESTART when the WAL passes
+// restart_pages and TRUNCATE past truncate_pages, each on its own
+// connection to the file
+// RESTART and TRUNCATE keep writers out while they wait for readers,
+// so they only run after a PASSIVE pass has caught up – a reader on
+// an old snapshot just leaves the WAL to grow, and counts as busy
+// remove() a connection before closing it; remove() puts sqlite's
+// default autocheckpoint back
+class BWCheckpointer {
+    using clock = std::chrono::steady_clock;
+
+    struct File {
+        std::string filename;
+        sqlite3 * ckpt_db = nullptr;
+        std::vector<sqlite3 *> conns;
+        std::atomic<int> wal_pages { 0 };
+        std::atomic<int> wal_pages_max { 0 };
+        std::atomic<int64_t> last_commit_ns { 0 };
+        std::mutex stats_lock;
+        BWCheckpointStats stats;
+        ~File();
+    };
+
+    int _interval_ms;
+    int _idle_ms;
+    int _restart_pages;
+    int _truncate_pages;
+    std::map<std::string, std::shared_ptr<File>> _files;
+    bool _stop = false;
+    std::mutex _lock;
+    std::condition_variable _wake;
+    std::thread _worker;
+
+public:
+    // ctor/dtor
+    BWCheckpointer(int idle_ms = DEFAULT_CKPT_IDLE_MS, int restart_pages = DEFAULT_CKPT_RESTART_PAGES,
+                   int truncate_pages = DEFAULT_CKPT_TRUNCATE_PAGES, int interval_ms = DEFAULT_CKPT_INTERVAL_MS);
+    ~BWCheckpointer();              // every connection must be removed first
+
+    // checkpoint methods
+    bool add(BWSQL & db);
+    bool add(sqlite3 * db);
+    void remove(BWSQL & db);
+    void remove(sqlite3 * db);
+    void checkpoint_now(int mode = SQLITE_CHECKPOINT_PASSIVE);    // every file, on this thread
+
+    // utilities
+    std::vector<BWCheckpointStats> stats();
+
+    // rule of five stuff
+    BWCheckpointer(const BWCheckpointer &)                = delete;   // no copy
+    BWCheckpointer & operator = (const BWCheckpointer &)  = delete;   // no assignment
+
+private:
+    static int _wal_hook(void * ctx, sqlite3 * db, const char * name, int pages);
+    void _run();
+    bool _checkpoint(File & f, int mode);
+    static int64_t _now_ns();
+};
+
+}
+
+#endif // BWCHECKPOINT_H
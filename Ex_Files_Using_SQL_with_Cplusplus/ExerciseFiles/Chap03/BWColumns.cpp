@@ -0,0 +1,135 @@
+//  BWColumns.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWColumns.h"
+#include <cstring>
+
+namespace bw {
+
+// MARK: - batch methods
+
+void ColumnBatch::kind(int col, ColumnKind kind) {
+    if(col >= (int) _columns.size()) {
+        _columns.resize((size_t) col + 1);
+    }
+    _columns[col].kind = kind;
+}
+
+void ColumnBatch::clear() {
+    for(Column & c : _columns) {
+        c.ints.clear();
+        c.reals.clear();
+        c.offsets.clear();
+        c.bytes.clear();
+        c.nulls.clear();
+    }
+    _num_rows = 0;
+}
+
+void ColumnBatch::reset() {
+    _columns.clear();
+    _num_rows = 0;
+}
+
+// steps stmt up to max_rows times
+// done is set when the result set runs out (or on error)
+int ColumnBatch::fill(sqlite3_stmt * stmt, int max_rows, bool * done) {
+    clear();
+    if(done) *done = false;
+    if(!stmt) {
+        if(done) *done = true;
+        return 0;
+    }
+    if(max_rows <= 0) {
+        max_rows = DEFAULT_BATCH_ROWS;
+    }
+
+    bool first = true;
+    while(_num_rows < max_rows) {
+        if(sqlite3_step(stmt) != SQLITE_ROW) {
+            if(done) *done = true;
+            break;
+        }
+        if(first) {
+            _setup(stmt);
+            for(Column & c : _columns) {
+                c.nulls.reserve((size_t) max_rows);
+                switch(c.kind) {
+                    case COLUMN_INT64: c.ints.reserve((size_t) max_rows); break;
+                    case COLUMN_DOUBLE: c.reals.reserve((size_t) max_rows); break;
+                    default: c.offsets.reserve((size_t) max_rows + 1); c.offsets.push_back(0); break;
+                }
+            }
+            first = false;
+        }
+
+        for(int col = 0; col < (int) _columns.size(); ++col) {
+            Column & c = _columns[col];
+            uint8_t is_null = sqlite3_column_type(stmt, col) == SQLITE_NULL;
+            c.nulls.push_back(is_null);
+            switch(c.kind) {
+                case COLUMN_INT64:
+                    c.ints.push_back(sqlite3_column_int64(stmt, col));
+                    break;
+                case COLUMN_DOUBLE:
+                    c.reals.push_back(sqlite3_column_double(stmt, col));
+                    break;
+                default: {
+                    // blob first, then bytes, so text isn't converted
+                    const char * data = (const char *) sqlite3_column_blob(stmt, col);
+                    int len = sqlite3_column_bytes(stmt, col);
+                    if(data && len > 0) {
+                        c.bytes.insert(c.bytes.end(), data, data + len);
+                    }
+                    c.offsets.push_back((uint32_t) c.bytes.size());
+                    break;
+                }
+            }
+        }
+        ++_num_rows;
+    }
+    return _num_rows;
+}
+
+// MARK: - private
+
+// names and kinds, once per statement shape
+void ColumnBatch::_setup(sqlite3_stmt * stmt) {
+    int count = sqlite3_column_count(stmt);
+    if((int) _columns.size() != count) {
+        _columns.resize((size_t) count);
+    }
+    for(int col = 0; col < count; ++col) {
+        Column & c = _columns[col];
+        const char * name = sqlite3_column_name(stmt, col);
+        if(name && c.name != name) {
+            c.name = name;
+        }
+        if(c.kind == COLUMN_AUTO) {
+            c.kind = _kind_for(stmt, col);
+        }
+    }
+}
+
+// declared type affinity (sqlite.org/datatype3.html), else the first row's type
+ColumnKind ColumnBatch::_kind_for(sqlite3_stmt * stmt, int col) {
+    const char * decl = sqlite3_column_decltype(stmt, col);
+    if(decl) {
+        char upper[64] = {};
+        for(size_t i = 0; decl[i] && i < sizeof(upper) - 1; ++i) {
+            char c = decl[i];
+            upper[i] = (c >= 'a' && c <= 'z') ? (char) (c - 0x20) : c;
+        }
+        if(strstr(upper, "INT")) return COLUMN_INT64;
+        if(strstr(upper, "CHAR") || strstr(upper, "CLOB") || strstr(upper, "TEXT")) return COLUMN_TEXT;
+        if(strstr(upper, "REAL") || strstr(upper, "FLOA") || strstr(upper, "DOUB")) return COLUMN_DOUBLE;
+    }
+    switch(sqlite3_column_type(stmt, col)) {
+        case SQLITE_INTEGER: return COLUMN_INT64;
+        case SQLITE_FLOAT: return COLUMN_DOUBLE;
+        default: return COLUMN_TEXT;
+    }
+}
+
+}
@@ -0,0 +1,78 @@
+//  BWColumns.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWCOLUMNS_H
+#define BWCOLUMNS_H
+
+#include <sqlite3.h>
+#include "BWBind.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bw {
+
+#define DEFAULT_BATCH_ROWS 1024
+
+enum ColumnKind {
+    COLUMN_AUTO = 0,    // decided from the declared type or the first row
+    COLUMN_INT64,
+    COLUMN_DOUBLE,
+    COLUMN_TEXT         // text and blobs, as offsets into one byte buffer
+};
+
+// one column of a batch, stored contiguously
+// only the vector for the column's kind is filled
+// null rows hold 0 (or an empty string) and are flagged in nulls
+struct Column {
+    ColumnKind kind = COLUMN_AUTO;
+    std::string name;
+    std::vector<int64_t> ints;
+    std::vector<double> reals;
+    std::vector<uint32_t> offsets;      // num_rows + 1 entries
+    std::vector<char> bytes;
+    std::vector<uint8_t> nulls;         // 1 for null
+
+    std::string_view text(int row) const {
+        return std::string_view(bytes.data() + offsets[row], offsets[row + 1] - offsets[row]);
+    }
+    blob blob_at(int row) const {
+        return blob{ bytes.data() + offsets[row], (int) (offsets[row + 1] - offsets[row]) };
+    }
+    bool is_null(int row) const { return nulls[row] != 0; }
+};
+
+// struct-of-arrays result buffer
+// reuse one batch across calls – clear() keeps the capacity,
+// so steady-state fetches don't allocate
+class ColumnBatch {
+    std::vector<Column> _columns;
+    int _num_rows = 0;
+
+public:
+    ColumnBatch() = default;
+
+    int num_rows() const { return _num_rows; }
+    int num_columns() const { return (int) _columns.size(); }
+    Column & column(int col) { return _columns[col]; }
+    const Column & column(int col) const { return _columns[col]; }
+
+    // force a column's kind, otherwise it's decided on the first fetch
+    void kind(int col, ColumnKind kind);
+    void clear();
+    void reset();   // forget the columns and their kinds
+
+    // fill with up to max_rows rows from stmt
+    // returns the number of rows, 0 at the end of the result set
+    int fill(sqlite3_stmt * stmt, int max_rows, bool * done = nullptr);
+
+private:
+    void _setup(sqlite3_stmt * stmt);
+    static ColumnKind _kind_for(sqlite3_stmt * stmt, int col);
+};
+
+}
+
+#endif // BWCOLUMNS_H
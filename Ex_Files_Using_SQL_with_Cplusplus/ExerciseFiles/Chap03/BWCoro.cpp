@@ -0,0 +1,97 @@
+//  BWCoro.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWCoro.h"
+
+#if defined(__cpp_impl_coroutine) && __cplusplus >= 202002L
+
+namespace bw {
+
+static thread_local CoScheduler * current_scheduler = nullptr;
+
+// MARK: - constructors
+
+CoScheduler::CoScheduler(int num_threads) {
+    if(num_threads < 1) {
+        num_threads = 1;
+    }
+    for(int index = 0; index < num_threads; ++index) {
+        _threads.emplace_back(&CoScheduler::_run, this);
+    }
+}
+
+CoScheduler::~CoScheduler() {
+    wait_idle();
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stop = true;
+    }
+    _have_work.notify_all();
+    for(std::thread & t : _threads) {
+        t.join();
+    }
+}
+
+// MARK: - scheduler methods
+
+void CoScheduler::spawn(CoTask && task) {
+    std::coroutine_handle<CoTask::promise_type> h = std::exchange(task._h, {});
+    if(!h) {
+        return;
+    }
+    h.promise()._scheduler = this;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        ++_active;
+    }
+    schedule(h);
+}
+
+// notify under the lock – the caller may be the last task and
+// the scheduler can be destroyed as soon as the lock is released
+void CoScheduler::schedule(std::coroutine_handle<> h) {
+    std::lock_guard<std::mutex> guard(_lock);
+    _ready.push_back(h);
+    _have_work.notify_one();
+}
+
+void CoScheduler::wait_idle() {
+    std::unique_lock<std::mutex> lock(_lock);
+    _idle.wait(lock, [this] { return _active == 0; });
+}
+
+CoScheduler * CoScheduler::current() {
+    return current_scheduler;
+}
+
+// MARK: - private
+
+void CoScheduler::_task_done() {
+    std::lock_guard<std::mutex> guard(_lock);
+    if(--_active == 0) {
+        _idle.notify_all();
+    }
+}
+
+void CoScheduler::_run() {
+    current_scheduler = this;
+    while(true) {
+        std::coroutine_handle<> h;
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _have_work.wait(lock, [this] { return !_ready.empty() || _stop; });
+            if(_ready.empty()) {
+                break;
+            }
+            h = _ready.front();
+            _ready.pop_front();
+        }
+        h.resume();
+    }
+    current_scheduler = nullptr;
+}
+
+}
+
+#endif // __cpp_impl_coroutine
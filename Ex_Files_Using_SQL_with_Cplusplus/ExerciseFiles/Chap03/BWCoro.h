@@ -0,0 +1,238 @@
+//  BWCoro.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWCORO_H
+#define BWCORO_H
+
+// C++20 coroutine support – this header is empty without it
+#if defined(__cpp_impl_coroutine) && __cplusplus >= 202002L
+
+#include "BWAsync.h"
+#include "BWStatement.h"
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bw {
+
+// MARK: - generator
+
+// lazily yields values from a coroutine, usable in range-for
+template<typename T>
+class generator {
+public:
+    struct promise_type {
+        T _value;
+
+        generator get_return_object() {
+            return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(T value) {
+            _value = std::move(value);
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    class iterator {
+        std::coroutine_handle<promise_type> _h;
+
+    public:
+        iterator() = default;
+        explicit iterator(std::coroutine_handle<promise_type> h) : _h(h) {}
+        const T & operator * () const { return _h.promise()._value; }
+        const T * operator -> () const { return &_h.promise()._value; }
+        iterator & operator ++ () {
+            _h.resume();
+            return *this;
+        }
+        // at the end when the coroutine has run off its end
+        bool operator == (const iterator &) const { return !_h || _h.done(); }
+        bool operator != (const iterator & other) const { return !(*this == other); }
+    };
+
+    explicit generator(std::coroutine_handle<promise_type> h) : _h(h) {}
+    ~generator() {
+        if(_h) _h.destroy();
+    }
+    generator(generator && other) noexcept : _h(std::exchange(other._h, {})) {}
+    generator & operator = (generator && other) noexcept {
+        if(this != &other) {
+            if(_h) _h.destroy();
+            _h = std::exchange(other._h, {});
+        }
+        return *this;
+    }
+    generator(const generator &)                = delete;
+    generator & operator = (const generator &)  = delete;
+
+    iterator begin() {
+        _h.resume();
+        return iterator(_h);
+    }
+    iterator end() { return iterator(); }
+
+private:
+    std::coroutine_handle<promise_type> _h;
+};
+
+// rows of a statement, stepped one at a time as the consumer asks
+// each RowView is valid until the next one is yielded
+inline generator<RowView> row_generator(Statement & st) {
+    while(RowView row = st.fetch_view()) {
+        co_yield row;
+    }
+}
+
+// MARK: - scheduler
+
+class CoScheduler;
+
+// a detached session coroutine, started with CoScheduler::spawn()
+class CoTask {
+public:
+    struct promise_type {
+        CoScheduler * _scheduler = nullptr;
+
+        CoTask get_return_object() {
+            return CoTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void();
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit CoTask(std::coroutine_handle<promise_type> h) : _h(h) {}
+    ~CoTask() {
+        if(_h) _h.destroy();    // never spawned
+    }
+    CoTask(CoTask && other) noexcept : _h(std::exchange(other._h, {})) {}
+    CoTask(const CoTask &)                = delete;
+    CoTask & operator = (const CoTask &)  = delete;
+
+private:
+    friend class CoScheduler;
+    std::coroutine_handle<promise_type> _h;
+};
+
+// a handful of threads that run many session coroutines
+// sessions awaiting a query are parked, not blocking a thread
+class CoScheduler {
+    std::vector<std::thread> _threads;
+    std::deque<std::coroutine_handle<>> _ready;
+    std::mutex _lock;
+    std::condition_variable _have_work;
+    std::condition_variable _idle;
+    int _active = 0;            // spawned tasks not yet finished
+    bool _stop = false;
+
+public:
+    explicit CoScheduler(int num_threads);
+    ~CoScheduler();             // waits for spawned tasks
+
+    void spawn(CoTask && task);
+    void schedule(std::coroutine_handle<> h);
+    void wait_idle();
+    static CoScheduler * current();     // nullptr off the scheduler threads
+
+    CoScheduler(const CoScheduler &)                = delete;
+    CoScheduler & operator = (const CoScheduler &)  = delete;
+
+private:
+    friend struct CoTask::promise_type;
+    void _task_done();
+    void _run();
+};
+
+inline void CoTask::promise_type::return_void() {
+    if(_scheduler) {
+        _scheduler->_task_done();
+    }
+}
+
+// MARK: - awaitable queries
+
+// co_await runs the statement on the AsyncBWSQL thread and resumes
+// on the awaiting scheduler (or the DB thread if there is none)
+// resumed on the DB thread, the next co_await can't wait for queue
+// space – it's queued over capacity, see AsyncBWSQL::_enqueue
+class AsyncQuery {
+    AsyncBWSQL * _db;
+    const char * _sql;
+    std::vector<Value> _params;
+    AsyncResult _result;
+
+public:
+    AsyncQuery(AsyncBWSQL & db, const char * sql, std::vector<Value> params)
+    : _db(&db), _sql(sql), _params(std::move(params)) {}
+
+    bool await_ready() const noexcept { return false; }
+    // the callback always runs, with SQLITE_MISUSE if the queue was
+    // stopped – then on this thread, before submit_values returns
+    bool await_suspend(std::coroutine_handle<> h) {
+        CoScheduler * scheduler = CoScheduler::current();
+        auto resume = [this, h, scheduler](AsyncResult && result) {
+            _result = std::move(result);
+            if(scheduler) {
+                scheduler->schedule(h);
+            } else {
+                h.resume();
+            }
+        };
+        // h may be resumed, and this awaiter gone, before this returns
+        _db->submit_values(std::move(resume), _sql, std::move(_params));
+        return true;
+    }
+    AsyncResult await_resume() { return std::move(_result); }
+};
+
+// first column of the first row, like BWSQL::sql_value
+class AsyncValue {
+    AsyncQuery _query;
+
+public:
+    AsyncValue(AsyncBWSQL & db, const char * sql, std::vector<Value> params)
+    : _query(db, sql, std::move(params)) {}
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> h) { return _query.await_suspend(h); }
+    Value await_resume() {
+        AsyncResult result = _query.await_resume();
+        if(result.rows.empty() || result.rows[0].empty()) {
+            return Value();
+        }
+        return std::move(result.rows[0][0]);
+    }
+};
+
+// AsyncResult r = co_await co_sql_do(adb, "UPDATE ...", a, b);
+template<typename... Args>
+AsyncQuery co_sql_do(AsyncBWSQL & db, const char * sql, Args &&... args) {
+    std::vector<Value> params;
+    (params.emplace_back(std::forward<Args>(args)), ...);
+    return AsyncQuery(db, sql, std::move(params));
+}
+
+// Value v = co_await co_sql_value(adb, "SELECT ...", a);
+template<typename... Args>
+AsyncValue co_sql_value(AsyncBWSQL & db, const char * sql, Args &&... args) {
+    std::vector<Value> params;
+    (params.emplace_back(std::forward<Args>(args)), ...);
+    return AsyncValue(db, sql, std::move(params));
+}
+
+}
+
+#endif // __cpp_impl_coroutine
+
+#endif // BWCORO_H
@@ -0,0 +1,134 @@
+//  BWCursor.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWCursor.h"
+
+namespace bw {
+
+// MARK: - constructors
+
+PrefetchCursor::PrefetchCursor(Statement && st, int capacity)
+: _st(std::move(st))
+{
+    if(capacity < 1) {
+        capacity = 1;
+    }
+    _ring.resize((size_t) capacity);
+    if(!_st) {
+        _done = true;
+        _rc = SQLITE_MISUSE;
+        return;
+    }
+    _worker = std::thread(&PrefetchCursor::_run, this);
+}
+
+// stops the worker if the consumer quits early
+PrefetchCursor::~PrefetchCursor() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stop = true;
+    }
+    _have_space.notify_one();
+    if(_worker.joinable()) {
+        _worker.join();
+    }
+    _st.reset();
+}
+
+// MARK: - cursor methods
+
+const Row * PrefetchCursor::next() {
+    std::unique_lock<std::mutex> lock(_lock);
+    if(_holding) {
+        // done with the last row, its slot is free again
+        _holding = false;
+        ++_consumed;
+        _have_space.notify_one();
+    }
+    if(_consumed == _produced && !_done) {
+        ++_stats.consumer_waits;
+        _have_row.wait(lock, [this] { return _consumed < _produced || _done; });
+    }
+    if(_consumed == _produced) {
+        return nullptr;
+    }
+    _holding = true;
+    return &_ring[_consumed % _ring.size()];
+}
+
+PrefetchCursor::iterator PrefetchCursor::begin() {
+    return iterator(this);
+}
+
+PrefetchCursor::iterator PrefetchCursor::end() {
+    return iterator();
+}
+
+// MARK: - utilities
+
+// the worker sets _rc under the lock, and may still be running
+int PrefetchCursor::error() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _rc;
+}
+
+PrefetchStats PrefetchCursor::stats() {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _stats;
+}
+
+// MARK: - private
+
+// worker thread – step and copy rows until done, full stop, or error
+void PrefetchCursor::_run() {
+    sqlite3_stmt * stmt = _st.stmt();
+    int num_columns = _st.num_columns();
+    for(Row & row : _ring) {
+        row.resize((size_t) num_columns);
+    }
+
+    while(true) {
+        // wait for a free slot before stepping
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            if(_produced - _consumed == _ring.size() && !_stop) {
+                ++_stats.producer_waits;
+                _have_space.wait(lock, [this] { return _produced - _consumed < _ring.size() || _stop; });
+            }
+            if(_stop) {
+                break;
+            }
+        }
+
+        int rc = _st.step();
+        if(rc != SQLITE_ROW) {
+            std::lock_guard<std::mutex> guard(_lock);
+            if(rc != SQLITE_DONE) {
+                _rc = rc;
+            }
+            break;
+        }
+
+        // the slot is ours, nobody reads it until _produced moves
+        Row & row = _ring[_produced % _ring.size()];
+        for(int col = 0; col < num_columns; ++col) {
+            row[(size_t) col].set_column(stmt, col);
+        }
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            ++_produced;
+            ++_stats.rows;
+        }
+        _have_row.notify_one();
+    }
+
+    sqlite3_reset(stmt);
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _done = true;
+    }
+    _have_row.notify_one();
+}
+
+}
@@ -0,0 +1,99 @@
+//  BWCursor.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWCURSOR_H
+#define BWCURSOR_H
+
+#include "BWRowView.h"
+#include "BWStatement.h"
+#include "BWValue.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bw {
+
+#define DEFAULT_PREFETCH_ROWS 256
+
+// MARK: - background prefetch
+
+// a row copied out of the statement
+using Row = std::vector<Value>;
+
+struct PrefetchStats {
+    uint64_t rows = 0;
+    uint64_t consumer_waits = 0;    // buffer was empty
+    uint64_t producer_waits = 0;    // buffer was full
+};
+
+// steps a statement on a worker thread into a bounded ring of rows,
+// so the consumer's work overlaps with sqlite's
+// the connection must not be used by other threads until the cursor
+// is finished – don't use this on a SQLITE_OPEN_NOMUTEX connection
+// that another thread is also using
+class PrefetchCursor {
+    Statement _st;
+    std::vector<Row> _ring;
+    uint64_t _produced = 0;
+    uint64_t _consumed = 0;
+    bool _holding = false;      // consumer holds the row at _consumed
+    bool _done = false;
+    bool _stop = false;
+    int _rc = SQLITE_OK;
+    PrefetchStats _stats;
+    mutable std::mutex _lock;
+    std::condition_variable _have_row;
+    std::condition_variable _have_space;
+    std::thread _worker;
+
+public:
+    class iterator {
+        PrefetchCursor * _cursor = nullptr;
+        const Row * _row = nullptr;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Row;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Row *;
+        using reference = const Row &;
+
+        iterator() = default;
+        explicit iterator(PrefetchCursor * cursor) : _cursor(cursor), _row(cursor->next()) {}
+        const Row & operator * () const { return *_row; }
+        const Row * operator -> () const { return _row; }
+        iterator & operator ++ () {
+            _row = _cursor->next();
+            return *this;
+        }
+        bool operator == (const iterator & other) const { return _row == other._row; }
+        bool operator != (const iterator & other) const { return _row != other._row; }
+    };
+
+    // ctor/dtor
+    PrefetchCursor(Statement && st, int capacity = DEFAULT_PREFETCH_ROWS);
+    ~PrefetchCursor();
+
+    // the next row, or nullptr at the end
+    // the row is valid until the following call
+    const Row * next();
+    iterator begin();
+    iterator end();
+
+    // utilities
+    int error() const;      // sqlite error that ended the scan, or SQLITE_OK
+    PrefetchStats stats();
+
+    PrefetchCursor(const PrefetchCursor &)                = delete;
+    PrefetchCursor & operator = (const PrefetchCursor &)  = delete;
+
+private:
+    void _run();
+};
+
+}
+
+#endif // BWCURSOR_H
@@ -0,0 +1,334 @@
+//  BWGroupCommit.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWGroupCommit.h"
+
+namespace bw {
+
+// MARK: - constructors
+
+// only the writer thread uses the connection, so it doesn't need sqlite's mutex
+GroupCommitWriter::GroupCommitWriter(const char * filename, const char * tablename,
+                                     int max_batch, int max_latency_ms)
+: _filename(filename), _head(&_stub), _tail(&_stub),
+  _max_batch(max_batch > 0 ? max_batch : 1),
+  _max_latency_ms(max_latency_ms > 0 ? max_latency_ms : 0)
+{
+    _db = std::make_unique<BWSQL>(_filename.c_str(),
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX);
+    _db->sql_do("PRAGMA journal_mode=WAL");
+    sqlite3_busy_timeout(_db->db(), DEFAULT_GROUP_BUSY_TIMEOUT);
+    if(tablename) {
+        _table = tablename;
+        _build_table_sql();
+    }
+    _writer = std::thread(&GroupCommitWriter::_run, this);
+}
+
+GroupCommitWriter::~GroupCommitWriter() {
+    _stop.store(true);
+    {
+        std::lock_guard<std::mutex> guard(_park_lock);
+        _wake.notify_one();
+    }
+    if(_writer.joinable()) {
+        _writer.join();
+    }
+
+    // anything that raced the stop never made it into a batch
+    while(Node * node = _pop()) {
+        GroupResult result;
+        result.rc = SQLITE_MISUSE;
+        result.error = "GroupCommitWriter is stopped";
+        node->promise.set_value(std::move(result));
+        delete node;
+    }
+}
+
+// MARK: - mutations
+
+std::future<GroupResult> GroupCommitWriter::delete_row(int id) {
+    std::vector<Value> params;
+    params.emplace_back(id);
+    return _submit(_delete_sql, std::move(params));
+}
+
+// MARK: - utilities
+
+// takes effect from the next batch
+void GroupCommitWriter::max_batch(int n) {
+    _max_batch.store(n > 0 ? n : 1);
+}
+
+// 0 commits as soon as the queue is drained
+void GroupCommitWriter::max_latency(int ms) {
+    _max_latency_ms.store(ms > 0 ? ms : 0);
+}
+
+GroupStats GroupCommitWriter::stats() const {
+    std::lock_guard<std::mutex> guard(_stats_lock);
+    GroupStats s = _stats;
+    s.submitted = _submitted.load();
+    s.avg_batch = s.batches ? (double) (s.committed + s.failed) / (double) s.batches : 0;
+    return s;
+}
+
+const char * GroupCommitWriter::filename() const {
+    return _filename.c_str();
+}
+
+const char * GroupCommitWriter::table_name() const {
+    return _table.empty() ? nullptr : _table.c_str();
+}
+
+// MARK: - private
+
+std::future<GroupResult> GroupCommitWriter::_submit(const std::string & sql, std::vector<Value> && params) {
+    if(sql.empty() || _stop.load()) {
+        std::promise<GroupResult> promise;
+        GroupResult result;
+        result.rc = SQLITE_MISUSE;
+        result.error = sql.empty() ? "GroupCommitWriter: no table" : "GroupCommitWriter is stopped";
+        promise.set_value(std::move(result));
+        return promise.get_future();
+    }
+    Node * node = new Node;
+    node->sql = sql;
+    node->params = std::move(params);
+    node->submitted = clock::now();
+    std::future<GroupResult> f = node->promise.get_future();
+    _submitted.fetch_add(1, std::memory_order_relaxed);
+    _push(node);
+    return f;
+}
+
+// any thread – wait-free, one exchange
+// the writer is only woken if it's parked
+void GroupCommitWriter::_push(Node * node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node * prev = _head.exchange(node);
+    prev->next.store(node, std::memory_order_release);
+    if(_sleeping.load()) {
+        std::lock_guard<std::mutex> guard(_park_lock);
+        _wake.notify_one();
+    }
+}
+
+// writer thread only
+// nullptr when empty, or when a producer is between its
+// exchange and its link – _empty() tells the two apart
+GroupCommitWriter::Node * GroupCommitWriter::_pop() {
+    Node * tail = _tail;
+    Node * next = tail->next.load(std::memory_order_acquire);
+    if(tail == &_stub) {
+        if(!next) {
+            return nullptr;
+        }
+        _tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if(next) {
+        _tail = next;
+        return tail;
+    }
+    if(tail != _head.load()) {
+        return nullptr;
+    }
+    _push(&_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if(next) {
+        _tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+bool GroupCommitWriter::_empty() const {
+    return _tail == &_stub && _head.load() == &_stub;
+}
+
+// _sleeping is set before the queue is checked, and producers check
+// it after they push, so a wakeup can't be missed
+void GroupCommitWriter::_park(clock::time_point until, bool timed) {
+    std::unique_lock<std::mutex> lock(_park_lock);
+    _sleeping.store(true);
+    if(_empty() && !_stop.load()) {
+        if(timed) {
+            _wake.wait_until(lock, until);
+        } else {
+            _wake.wait(lock);
+        }
+    }
+    _sleeping.store(false);
+}
+
+// writer thread – gather a batch, commit it, repeat
+void GroupCommitWriter::_run() {
+    std::vector<Node *> batch;
+    while(true) {
+        Node * node = _pop();
+        if(!node) {
+            if(!_empty()) {
+                std::this_thread::yield();      // a push is half done
+            } else if(_stop.load()) {
+                break;
+            } else {
+                _park(clock::time_point(), false);
+            }
+            continue;
+        }
+
+        // the first mutation starts the latency clock
+        batch.push_back(node);
+        int max_batch = _max_batch.load();
+        clock::time_point deadline = clock::now() + std::chrono::milliseconds(_max_latency_ms.load());
+        while((int) batch.size() < max_batch) {
+            if((node = _pop())) {
+                batch.push_back(node);
+            } else if(!_empty()) {
+                std::this_thread::yield();
+            } else if(_stop.load() || clock::now() >= deadline) {
+                break;
+            } else {
+                _park(deadline, true);
+            }
+        }
+        _commit_batch(batch);
+        batch.clear();
+    }
+}
+
+// one transaction for the batch, then acknowledge everyone
+void GroupCommitWriter::_commit_batch(std::vector<Node *> & batch) {
+    sqlite3 * db = _db->db();
+    std::vector<GroupResult> results(batch.size());
+    int batch_rc = sqlite3_exec(db, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr);
+    std::string batch_error;
+    double commit_ms = 0;
+    if(batch_rc != SQLITE_OK) {
+        batch_error = sqlite3_errmsg(db);
+    } else {
+        for(size_t index = 0; index < batch.size(); ++index) {
+            Node * node = batch[index];
+            GroupResult & result = results[index];
+            Statement st(*_db, node->sql.c_str());
+            sqlite3_stmt * stmt = st.stmt();
+            if(!stmt) {
+                result.rc = sqlite3_errcode(db);
+                result.error = sqlite3_errmsg(db);
+                continue;
+            }
+            if(sqlite3_bind_parameter_count(stmt) != (int) node->params.size()) {
+                result.rc = SQLITE_RANGE;
+                result.error = "wrong number of bind parameters";
+                continue;
+            }
+            int rc = SQLITE_OK;
+            for(size_t param = 0; rc == SQLITE_OK && param < node->params.size(); ++param) {
+                rc = bind_param(stmt, (int) param + 1, node->params[param]);
+            }
+            if(rc == SQLITE_OK) {
+                rc = st.step();
+            }
+            result.rc = rc;
+            if(rc == SQLITE_DONE) {
+                result.changes = sqlite3_changes(db);
+                result.last_insert_rowid = sqlite3_last_insert_rowid(db);
+            } else {
+                result.error = sqlite3_errmsg(db);
+            }
+            st.reset();
+
+            // some errors (SQLITE_FULL, SQLITE_IOERR, ...) roll back the
+            // whole transaction, not just the statement
+            if(rc != SQLITE_DONE && sqlite3_get_autocommit(db)) {
+                batch_rc = rc;
+                batch_error = result.error;
+                break;
+            }
+        }
+        if(batch_rc == SQLITE_OK) {
+            clock::time_point commit_start = clock::now();
+            batch_rc = sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr);
+            commit_ms = std::chrono::duration<double, std::milli>(clock::now() - commit_start).count();
+            if(batch_rc != SQLITE_OK) {
+                batch_error = sqlite3_errmsg(db);
+                sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+            }
+        }
+    }
+
+    clock::time_point now = clock::now();
+    uint64_t committed = 0;
+    uint64_t failed = 0;
+    double latency_max = 0;
+    double latency_total = 0;
+    for(size_t index = 0; index < batch.size(); ++index) {
+        GroupResult & result = results[index];
+        if(batch_rc != SQLITE_OK) {
+            result.rc = batch_rc;
+            result.error = batch_error;
+            result.changes = 0;
+            result.last_insert_rowid = 0;
+        }
+        result.batch_size = (int) batch.size();
+        result.latency_ms = std::chrono::duration<double, std::milli>(now - batch[index]->submitted).count();
+        latency_total += result.latency_ms;
+        if(result.latency_ms > latency_max) latency_max = result.latency_ms;
+        if(result.ok()) {
+            ++committed;
+        } else {
+            ++failed;
+        }
+    }
+
+    // stats before acks, so a submitter sees its own batch counted
+    {
+        std::lock_guard<std::mutex> guard(_stats_lock);
+        ++_stats.batches;
+        _stats.committed += committed;
+        _stats.failed += failed;
+        if(batch_rc != SQLITE_OK) ++_stats.rollbacks;
+        if((int) batch.size() > _stats.max_batch) _stats.max_batch = (int) batch.size();
+        _stats.commit_ms_total += commit_ms;
+        if(commit_ms > _stats.commit_ms_max) _stats.commit_ms_max = commit_ms;
+        _stats.latency_ms_total += latency_total;
+        if(latency_max > _stats.latency_ms_max) _stats.latency_ms_max = latency_max;
+    }
+
+    for(size_t index = 0; index < batch.size(); ++index) {
+        batch[index]->promise.set_value(std::move(results[index]));
+        delete batch[index];
+    }
+}
+
+// same statements BWCRUD builds, less the id column
+void GroupCommitWriter::_build_table_sql() {
+    std::string select = "SELECT * FROM " + _table;
+    Statement st(*_db, select.c_str());
+    const char ** col_names = st.column_names();
+    if(!st || !col_names) {
+        printf("GroupCommitWriter: no table %s\n", _table.c_str());
+        return;
+    }
+    std::string columns;
+    std::string holders;
+    std::string assigns;
+    for(int index = 1; index < st.num_columns(); ++index) {
+        const char * sep = (index > 1) ? "," : "";
+        columns += sep;
+        columns += col_names[index];
+        holders += sep;
+        holders += "?";
+        assigns += (index > 1) ? ", " : "";
+        assigns += col_names[index];
+        assigns += " = ?";
+    }
+    _insert_sql = "INSERT INTO " + _table + " (" + columns + ") VALUES (" + holders + ")";
+    _update_sql = "UPDATE " + _table + " SET " + assigns + " WHERE id = ?";
+    _delete_sql = "DELETE FROM " + _table + " WHERE id = ?";
+}
+
+}
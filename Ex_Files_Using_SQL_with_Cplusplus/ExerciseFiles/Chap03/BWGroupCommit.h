@@ -0,0 +1,159 @@
+//  BWGroupCommit.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWGROUPCOMMIT_H
+#define BWGROUPCOMMIT_H
+
+#include "BWSQL.h"
+#include "BWValue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bw {
+
+#define DEFAULT_GROUP_MAX_BATCH 256
+#define DEFAULT_GROUP_MAX_LATENCY_MS 2
+#define DEFAULT_GROUP_BUSY_TIMEOUT 5000     // ms
+
+// one mutation, acknowledged after its batch commits
+struct GroupResult {
+    int rc = SQLITE_OK;         // SQLITE_DONE once committed, or the error
+    std::string error;
+    int changes = 0;
+    int64_t last_insert_rowid = 0;
+    int batch_size = 0;         // mutations in the same transaction
+    double latency_ms = 0;      // submit to acknowledgement
+
+    bool ok() const { return rc == SQLITE_DONE; }
+};
+
+struct GroupStats {
+    uint64_t submitted = 0;
+    uint64_t committed = 0;
+    uint64_t failed = 0;        // statement errors and rolled back batches
+    uint64_t batches = 0;
+    uint64_t rollbacks = 0;
+    int max_batch = 0;
+    double avg_batch = 0;
+    double commit_ms_total = 0; // COMMIT alone, where the sync happens
+    double commit_ms_max = 0;
+    double latency_ms_total = 0;
+    double latency_ms_max = 0;
+};
+
+// a single writer thread with group commit
+// any thread submits mutations to a lock-free queue; the writer
+// drains up to max_batch of them, waiting at most max_latency_ms for
+// more to arrive, and runs them in one BEGIN IMMEDIATE ... COMMIT
+// each submitter's future is fulfilled after the COMMIT returns,
+// so one sync covers the whole batch
+// a failing statement is reported to its own submitter only, unless
+// sqlite rolled back the transaction – then the whole batch fails
+class GroupCommitWriter {
+    using clock = std::chrono::steady_clock;
+
+    // intrusive node for the MPSC queue
+    struct Node {
+        std::atomic<Node *> next { nullptr };
+        std::string sql;
+        std::vector<Value> params;
+        std::promise<GroupResult> promise;
+        clock::time_point submitted;
+    };
+
+    std::string _filename;
+    std::unique_ptr<BWSQL> _db;
+    std::string _table;
+    std::string _insert_sql;
+    std::string _update_sql;
+    std::string _delete_sql;
+
+    // Vyukov's intrusive MPSC queue – producers exchange _head,
+    // only the writer thread touches _tail
+    std::atomic<Node *> _head;
+    Node * _tail;
+    Node _stub;
+
+    std::atomic<int> _max_batch { DEFAULT_GROUP_MAX_BATCH };
+    std::atomic<int> _max_latency_ms { DEFAULT_GROUP_MAX_LATENCY_MS };
+    std::atomic<bool> _stop { false };
+    std::atomic<bool> _sleeping { false };
+    std::atomic<uint64_t> _submitted { 0 };
+    std::mutex _park_lock;
+    std::condition_variable _wake;
+    mutable std::mutex _stats_lock;
+    GroupStats _stats;
+    std::thread _writer;
+
+public:
+    // ctor/dtor
+    GroupCommitWriter(const char * filename, const char * tablename = nullptr,
+                      int max_batch = DEFAULT_GROUP_MAX_BATCH,
+                      int max_latency_ms = DEFAULT_GROUP_MAX_LATENCY_MS);
+    ~GroupCommitWriter();       // commits everything submitted first
+
+    // any statement, with its parameters
+    template<typename... Args> std::future<GroupResult> submit(const char * sql, Args &&... args);
+
+    // BWCRUD style mutations on the table, columns in table order less id
+    template<typename... Args> std::future<GroupResult> insert(Args &&... args);
+    template<typename... Args> std::future<GroupResult> update_row(int id, Args &&... args);
+    std::future<GroupResult> delete_row(int id);
+
+    // utilities
+    void max_batch(int n);
+    void max_latency(int ms);
+    GroupStats stats() const;
+    const char * filename() const;
+    const char * table_name() const;
+
+    GroupCommitWriter(const GroupCommitWriter &)                = delete;
+    GroupCommitWriter & operator = (const GroupCommitWriter &)  = delete;
+
+private:
+    std::future<GroupResult> _submit(const std::string & sql, std::vector<Value> && params);
+    void _push(Node * node);
+    Node * _pop();
+    bool _empty() const;
+    void _park(clock::time_point until, bool timed);
+    void _run();
+    void _commit_batch(std::vector<Node *> & batch);
+    void _build_table_sql();
+};
+
+template<typename... Args>
+std::future<GroupResult> GroupCommitWriter::submit(const char * sql, Args &&... args) {
+    std::vector<Value> params;
+    params.reserve(sizeof...(Args));
+    (params.emplace_back(std::forward<Args>(args)), ...);
+    return _submit(sql, std::move(params));
+}
+
+template<typename... Args>
+std::future<GroupResult> GroupCommitWriter::insert(Args &&... args) {
+    std::vector<Value> params;
+    params.reserve(sizeof...(Args));
+    (params.emplace_back(std::forward<Args>(args)), ...);
+    return _submit(_insert_sql, std::move(params));
+}
+
+template<typename... Args>
+std::future<GroupResult> GroupCommitWriter::update_row(int id, Args &&... args) {
+    std::vector<Value> params;
+    params.reserve(sizeof...(Args) + 1);
+    (params.emplace_back(std::forward<Args>(args)), ...);
+    params.emplace_back(id);
+    return _submit(_update_sql, std::move(params));
+}
+
+}
+
+#endif // BWGROUPCOMMIT_H
@@ -0,0 +1,249 @@
+//  BWHotCache.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWHotCache.h"
+#include <unistd.h>
+
+namespace bw {
+
+// MARK: - constructors
+
+// FULLMUTEX – the timer persists from its own thread
+BWHotCache::BWHotCache(const char * filename, int persist_ms)
+: BWSQL(":memory:", SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX),
+  _path(filename), _persist_ms(persist_ms > 0 ? persist_ms : 0)
+{
+    if(!db()) {
+        return;
+    }
+    sqlite3_commit_hook(db(), _commit_hook, this);
+    load();
+    if(_persist_ms) {
+        _timer = std::thread(&BWHotCache::_run, this);
+    }
+}
+
+BWHotCache::~BWHotCache() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stop = true;
+    }
+    _wake.notify_one();
+    if(_timer.joinable()) {
+        _timer.join();
+    }
+    if(db()) {
+        std::lock_guard<std::mutex> guard(_lock);
+        if(_dirty()) {
+            _persist(false);
+        }
+        sqlite3_commit_hook(db(), nullptr, nullptr);
+    }
+    if(_file_db) {
+        sqlite3_close(_file_db);
+    }
+}
+
+// MARK: - hot cache methods
+
+bool BWHotCache::load() {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _load();
+}
+
+bool BWHotCache::persist() {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _persist(false);
+}
+
+bool BWHotCache::dirty() {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _dirty();
+}
+
+// MARK: - utilities
+
+const char * BWHotCache::path() const {
+    return _path;
+}
+
+BWHotStats BWHotCache::stats() {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _stats;
+}
+
+double BWHotCache::unpersisted_ms() {
+    int64_t since = _dirty_since_ns.load(std::memory_order_relaxed);
+    if(!since) {
+        return 0;
+    }
+    return (double) (_now_ns() - since) / 1e6;
+}
+
+// MARK: - private
+
+// any commit on the connection, including DDL
+// the first one after a persist starts the window that a crash would lose
+int BWHotCache::_commit_hook(void * self) {
+    BWHotCache * hot = (BWHotCache *) self;
+    hot->_commits.fetch_add(1, std::memory_order_relaxed);
+    int64_t none = 0;
+    hot->_dirty_since_ns.compare_exchange_strong(none, _now_ns(), std::memory_order_relaxed);
+    return 0;
+}
+
+void BWHotCache::_run() {
+    std::unique_lock<std::mutex> lock(_lock);
+    while(!_stop) {
+        _wake.wait_for(lock, std::chrono::milliseconds(_persist_ms), [this] { return _stop; });
+        if(!_stop && _dirty()) {
+            _persist(true);
+        }
+    }
+}
+
+// caller holds _lock
+// a missing file is an empty database, created on the first persist –
+// not an error, what's in memory is emptied
+bool BWHotCache::_load() {
+    clock::time_point start = clock::now();
+    sqlite3_int64 size = 0;
+    int rc = SQLITE_OK;
+    if(access(_path, F_OK) != 0) {
+        reset_stmt();
+        rc = sqlite3_deserialize(db(), "main", nullptr, 0, 0,
+                                 SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_RESIZEABLE);
+    } else {
+        sqlite3 * src = nullptr;
+        if(sqlite3_open_v2(_path, &src, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+            printf("BWHotCache load: %s: %s\n", _path, sqlite3_errmsg(src));
+            sqlite3_close(src);
+            return false;
+        }
+
+        reset_stmt();
+        unsigned char * data = sqlite3_serialize(src, "main", &size, 0);
+        if(data && size > 0) {
+            // bytes 18 and 19 are 2 for WAL, which memdb can't do
+            if(size >= 20 && data[18] == 2) {
+                data[18] = 1;
+                data[19] = 1;
+            }
+            rc = sqlite3_deserialize(db(), "main", data, size, size,
+                                     SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_RESIZEABLE);
+        } else if(!data) {
+            // no serialize in this build, copy the pages instead
+            sqlite3_backup * backup = sqlite3_backup_init(db(), "main", src, "main");
+            if(backup) {
+                sqlite3_backup_step(backup, -1);
+                size = (sqlite3_int64) sqlite3_backup_pagecount(backup) * _page_size(src);
+                rc = sqlite3_backup_finish(backup);
+            } else {
+                rc = sqlite3_errcode(db());
+            }
+        } else {
+            sqlite3_free(data);
+        }
+        sqlite3_close(src);
+    }
+    if(rc != SQLITE_OK) {
+        error_msg("BWHotCache load");
+        return false;
+    }
+
+    _stats.bytes = size;
+    _stats.load_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    _persisted_commits = _commits.load(std::memory_order_relaxed);
+    _dirty_since_ns.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+// caller holds _lock
+// the connection's mutex is held for the whole copy, so no statement
+// on another thread can change the database halfway through
+// an open transaction would be copied uncommitted – the timer
+// skips that tick, persist() reports it
+bool BWHotCache::_persist(bool from_timer) {
+    sqlite3_mutex * db_mutex = sqlite3_db_mutex(db());
+    sqlite3_mutex_enter(db_mutex);
+    if(!sqlite3_get_autocommit(db())) {
+        sqlite3_mutex_leave(db_mutex);
+        if(from_timer) {
+            ++_stats.skipped;
+        } else {
+            printf("BWHotCache persist: transaction open\n");
+        }
+        return false;
+    }
+
+    if(!_file_db) {
+        if(sqlite3_open_v2(_path, &_file_db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+            printf("BWHotCache persist: %s\n", sqlite3_errmsg(_file_db));
+            sqlite3_close(_file_db);
+            _file_db = nullptr;
+            sqlite3_mutex_leave(db_mutex);
+            return false;
+        }
+        sqlite3_busy_timeout(_file_db, DEFAULT_HOT_BUSY_TIMEOUT);
+    }
+
+    // no commit can land while the mutex is held
+    clock::time_point start = clock::now();
+    uint64_t commits = _commits.load(std::memory_order_relaxed);
+    int64_t dirty_since = _dirty_since_ns.load(std::memory_order_relaxed);
+    int rc = SQLITE_OK;
+    int pages = 0;
+    sqlite3_backup * backup = sqlite3_backup_init(_file_db, "main", db(), "main");
+    if(backup) {
+        sqlite3_backup_step(backup, -1);
+        pages = sqlite3_backup_pagecount(backup);
+        rc = sqlite3_backup_finish(backup);
+    } else {
+        rc = sqlite3_errcode(_file_db);
+    }
+    if(rc == SQLITE_OK) {
+        _dirty_since_ns.store(0, std::memory_order_relaxed);
+    }
+    sqlite3_mutex_leave(db_mutex);
+
+    if(rc != SQLITE_OK) {
+        printf("BWHotCache persist: %s\n", sqlite3_errmsg(_file_db));
+        return false;
+    }
+    clock::time_point end = clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    if(commits != _persisted_commits && dirty_since) {
+        double window = (double) (_now_ns() - dirty_since) / 1e6;
+        _stats.window_ms_max = std::max(_stats.window_ms_max, window);
+    }
+    ++_stats.persists;
+    _stats.pages = pages;
+    _stats.persist_ms = ms;
+    _stats.persist_ms_total += ms;
+    _stats.persist_ms_max = std::max(_stats.persist_ms_max, ms);
+    _persisted_commits = commits;
+    return true;
+}
+
+int64_t BWHotCache::_page_size(sqlite3 * db) {
+    sqlite3_stmt * stmt = nullptr;
+    int64_t size = 0;
+    if(sqlite3_prepare_v2(db, "PRAGMA page_size", -1, &stmt, nullptr) == SQLITE_OK
+       && sqlite3_step(stmt) == SQLITE_ROW) {
+        size = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return size;
+}
+
+int64_t BWHotCache::_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+}
+
+// caller holds _lock
+bool BWHotCache::_dirty() const {
+    return _commits.load(std::memory_order_relaxed) != _persisted_commits;
+}
+
+}
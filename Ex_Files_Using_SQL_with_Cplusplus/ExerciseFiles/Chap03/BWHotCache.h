@@ -0,0 +1,84 @@
+//  BWHotCache.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWHOTCACHE_H
+#define BWHOTCACHE_H
+
+#include "BWSQL.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace bw {
+
+#define DEFAULT_HOT_BUSY_TIMEOUT 5000
+
+struct BWHotStats {
+    int64_t bytes = 0;              // loaded from the file
+    double load_ms = 0;
+    uint64_t persists = 0;
+    uint64_t skipped = 0;           // timer ticks that found a transaction open
+    int64_t pages = 0;              // in the last persist
+    double persist_ms = 0;          // last
+    double persist_ms_total = 0;
+    double persist_ms_max = 0;
+    double window_ms_max = 0;       // longest changes went unpersisted
+};
+
+// a small, hot database served entirely from memory
+// the file is copied in at open – sqlite3_serialize on a side
+// connection, sqlite3_deserialize into this one – and written back with
+// the backup API on persist(), every persist_ms if that's set, and
+// at destruction. anything changed since the last persist is lost
+// in a crash – stats().window_ms_max is how long that has been
+// nothing else may write the file while it's open
+class BWHotCache : public BWSQL {
+    using clock = std::chrono::steady_clock;
+
+    const char * _path = nullptr;
+    sqlite3 * _file_db = nullptr;           // persist destination, opened on first use
+    int _persist_ms = 0;
+    std::atomic<uint64_t> _commits { 0 };   // from the commit hook, DDL included
+    uint64_t _persisted_commits = 0;
+    std::atomic<int64_t> _dirty_since_ns { 0 };    // first commit since the last persist, 0 if none
+    BWHotStats _stats;
+    bool _stop = false;
+    std::mutex _lock;
+    std::condition_variable _wake;
+    std::thread _timer;
+
+public:
+    // ctor/dtor
+    BWHotCache(const char * filename, int persist_ms = 0);
+    ~BWHotCache();
+
+    // hot cache methods
+    bool load();                // from the file, replacing what's in memory
+    bool persist();             // to the file, now
+    bool dirty();
+
+    // utilities
+    const char * path() const;
+    BWHotStats stats();
+    double unpersisted_ms();    // since the first commit not yet persisted, 0 if none
+
+    // rule of five stuff
+    BWHotCache(const BWHotCache &)                = delete;   // no copy
+    BWHotCache & operator = (const BWHotCache &)  = delete;   // no assignment
+
+private:
+    static int _commit_hook(void * self);
+    void _run();
+    bool _load();
+    bool _persist(bool from_timer);
+    bool _dirty() const;
+    static int64_t _page_size(sqlite3 * db);
+    static int64_t _now_ns();
+};
+
+}
+
+#endif // BWHOTCACHE_H
@@ -0,0 +1,167 @@
+//  BWOpenProfile.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWOpenProfile.h"
+#include "BWVfs.h"
+#include <cstdio>
+#include <cstring>
+
+namespace bw {
+
+constexpr int rw_flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+
+// MARK: - profiles
+
+//  name, flags, uri_params, journal_mode, synchronous, temp_store,
+//  cache_size, mmap_size, wal_autocheckpoint, busy_timeout, lookaside size/count, vfs
+
+const OpenProfile profile_default = {
+    "default", rw_flags, nullptr, nullptr, nullptr, nullptr,
+    0, -1, -1, -1, 0, 0, nullptr
+};
+
+const OpenProfile profile_wal = {
+    "wal", rw_flags, nullptr, "WAL", nullptr, nullptr,
+    0, -1, -1, -1, 0, 0, nullptr
+};
+
+// synchronous OFF – an app crash can lose the load but leaves the file
+// sound; an OS crash or power loss can corrupt it, so load into a file
+// that can be rebuilt from its source
+// rare checkpoints, a 64 MiB page cache
+const OpenProfile profile_bulk_load = {
+    "bulk-load", rw_flags, nullptr, "WAL", "OFF", "MEMORY",
+    -65536, 256ll << 20, 10000, 5000, 1200, 500, nullptr
+};
+
+// NORMAL is durable across app crashes in WAL mode
+// a busy timeout so writers queue instead of failing
+const OpenProfile profile_oltp = {
+    "oltp", rw_flags, nullptr, "WAL", "NORMAL", "MEMORY",
+    -16384, 64ll << 20, 1000, 5000, 512, 256, nullptr
+};
+
+// read-only with a big mmap window and page cache for scans
+const OpenProfile profile_read_only = {
+    "read-only-analytics", SQLITE_OPEN_READONLY, nullptr, nullptr, nullptr, "MEMORY",
+    -131072, 1ll << 30, -1, 5000, 1200, 200, nullptr
+};
+
+// mmap covers the whole file (sqlite caps it at SQLITE_MAX_MMAP_SIZE),
+// so the page cache only holds what mmap can't – a small one will do
+const OpenProfile profile_read_only_mmap = {
+    "read-only-mmap", SQLITE_OPEN_READONLY | SQLITE_OPEN_URI, "mode=ro&immutable=1",
+    nullptr, nullptr, "MEMORY",
+    -2048, 2ll << 30, -1, -1, 1200, 200, nullptr
+};
+
+static const OpenProfile * const profiles[] = {
+    &profile_default, &profile_wal, &profile_bulk_load, &profile_oltp, &profile_read_only,
+    &profile_read_only_mmap, nullptr
+};
+
+const OpenProfile * find_profile(const char * name) {
+    if(!name) {
+        return nullptr;
+    }
+    for(int index = 0; profiles[index]; ++index) {
+        if(!strcmp(profiles[index]->name, name)) {
+            return profiles[index];
+        }
+    }
+    return nullptr;
+}
+
+const OpenProfile * const * all_profiles() {
+    return profiles;
+}
+
+// MARK: - open
+
+// sqlite.org/uri.html – '?', '#' and '%' in the path must be escaped
+std::string profile_uri(const char * filename, const char * params) {
+    std::string uri = "file:";
+    for(const char * p = filename; *p; ++p) {
+        if(*p == '?' || *p == '#' || *p == '%') {
+            char hex[4];
+            snprintf(hex, sizeof(hex), "%%%02X", (unsigned char) *p);
+            uri += hex;
+        } else {
+            uri += *p;
+        }
+    }
+    if(params && *params) {
+        uri += '?';
+        uri += params;
+    }
+    return uri;
+}
+
+int open_with_profile(const char * filename, sqlite3 ** db, const OpenProfile & profile, int * open_rc) {
+    if(profile.vfs && !strcmp(profile.vfs, BW_VFS_NAME)) {
+        io_vfs_register();
+    }
+    int rc = SQLITE_OK;
+    if(profile.uri_params) {
+        std::string uri = profile_uri(filename, profile.uri_params);
+        rc = sqlite3_open_v2(uri.c_str(), db, profile.flags | SQLITE_OPEN_URI, profile.vfs);
+    } else {
+        rc = sqlite3_open_v2(filename, db, profile.flags, profile.vfs);
+    }
+    if(open_rc) *open_rc = rc;
+    if(rc != SQLITE_OK) {
+        return rc;
+    }
+    return apply_profile(*db, profile);
+}
+
+// returns the first error, later settings are still tried
+int apply_profile(sqlite3 * db, const OpenProfile & profile) {
+    int first_rc = SQLITE_OK;
+    auto pragma = [&](const char * fmt, auto value) {
+        char * sql = sqlite3_mprintf(fmt, value);
+        int rc = sqlite3_exec(db, sql, nullptr, nullptr, nullptr);
+        if(rc != SQLITE_OK) {
+            printf("%s: %s\n", sql, sqlite3_errmsg(db));
+            if(first_rc == SQLITE_OK) first_rc = rc;
+        }
+        sqlite3_free(sql);
+    };
+
+    // SQLITE_BUSY if the connection's lookaside memory is in use
+    if(profile.lookaside_size > 0 && profile.lookaside_count > 0) {
+        int rc = sqlite3_db_config(db, SQLITE_DBCONFIG_LOOKASIDE, nullptr,
+                                   profile.lookaside_size, profile.lookaside_count);
+        if(rc != SQLITE_OK) {
+            printf("lookaside %d x %d: %s\n", profile.lookaside_size, profile.lookaside_count,
+                   sqlite3_errstr(rc));
+            if(first_rc == SQLITE_OK) first_rc = rc;
+        }
+    }
+    if(profile.busy_timeout >= 0) {
+        int rc = sqlite3_busy_timeout(db, profile.busy_timeout);
+        if(rc != SQLITE_OK && first_rc == SQLITE_OK) first_rc = rc;
+    }
+    if(profile.journal_mode) {
+        pragma("PRAGMA journal_mode=%s", profile.journal_mode);
+    }
+    if(profile.synchronous) {
+        pragma("PRAGMA synchronous=%s", profile.synchronous);
+    }
+    if(profile.temp_store) {
+        pragma("PRAGMA temp_store=%s", profile.temp_store);
+    }
+    if(profile.cache_size) {
+        pragma("PRAGMA cache_size=%d", profile.cache_size);
+    }
+    if(profile.mmap_size >= 0) {
+        pragma("PRAGMA mmap_size=%lld", (long long) profile.mmap_size);
+    }
+    if(profile.wal_autocheckpoint >= 0) {
+        pragma("PRAGMA wal_autocheckpoint=%d", profile.wal_autocheckpoint);
+    }
+    return first_rc;
+}
+
+}
@@ -0,0 +1,66 @@
+//  BWOpenProfile.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWOPENPROFILE_H
+#define BWOPENPROFILE_H
+
+#include <sqlite3.h>
+#include <sqlcpp.h>
+#include <cstdint>
+#include <string>
+
+namespace bw {
+
+// connection settings applied once, at open
+// nullptr strings and -1 numbers leave sqlite's default alone
+struct OpenProfile {
+    const char * name;
+    int flags;                      // sqlite3_open_v2
+    const char * uri_params;        // "mode=ro&immutable=1", opens the file as a URI
+    const char * journal_mode;      // "WAL", "DELETE", ...
+    const char * synchronous;       // "OFF", "NORMAL", "FULL"
+    const char * temp_store;        // "MEMORY", "FILE"
+    int cache_size;                 // pages, or KiB if negative (0 leaves it)
+    int64_t mmap_size;              // bytes
+    int wal_autocheckpoint;         // pages, 0 turns it off
+    int busy_timeout;               // ms
+    int lookaside_size;             // bytes per slot (0 leaves it)
+    int lookaside_count;            // slots
+    const char * vfs;               // e.g. BW_VFS_NAME, nullptr for the default
+};
+
+// nothing changed – plain BWSQL
+extern const OpenProfile profile_default;
+// WAL only – what BWCRUD has always done
+extern const OpenProfile profile_wal;
+// big transactions, nobody waiting on durability
+extern const OpenProfile profile_bulk_load;
+// many small transactions with readers alongside
+extern const OpenProfile profile_oltp;
+// large scans over a file nobody is writing
+extern const OpenProfile profile_read_only;
+// reference data that never changes while open, e.g. world.db
+// immutable=1 skips locking and change detection, and pages are
+// read through mmap instead of read() – nothing may write the file
+extern const OpenProfile profile_read_only_mmap;
+
+// by name, e.g. "oltp" or "bulk-load", nullptr if unknown
+const OpenProfile * find_profile(const char * name);
+const OpenProfile * const * all_profiles();     // nullptr terminated
+
+// "file:<path>?<params>", with the path escaped for sqlite
+std::string profile_uri(const char * filename, const char * params);
+
+// open a connection with the profile, as sqlite3_open_v2
+// lookaside must be configured before the connection is used,
+// so this is the only place it can be set
+// returns the first error, the open's or a setting's – a connection
+// whose settings failed is still open; open_rc gets the open's alone
+int open_with_profile(const char * filename, sqlite3 ** db, const OpenProfile & profile,
+                      int * open_rc = nullptr);
+int apply_profile(sqlite3 * db, const OpenProfile & profile);
+
+}
+
+#endif // BWOPENPROFILE_H
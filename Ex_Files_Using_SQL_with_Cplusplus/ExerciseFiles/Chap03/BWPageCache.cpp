@@ -0,0 +1,547 @@
+//  BWPageCache.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWPageCache.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define BW_PCACHE_MMAP 1
+#endif
+
+namespace bw {
+
+static thread_local const void * pcache_owner = nullptr;
+
+// MARK: - owner
+
+BWPageCacheOwner::BWPageCacheOwner(const void * owner)
+: _previous(pcache_owner)
+{
+    pcache_owner = owner;
+}
+
+BWPageCacheOwner::~BWPageCacheOwner() {
+    pcache_owner = _previous;
+}
+
+const void * BWPageCacheOwner::current() {
+    return pcache_owner;
+}
+
+// MARK: - slabs
+
+// one region, carved a chunk at a time for whichever slot size
+// asks next; a freed slot goes on its size's free list and is never
+// returned to the region. anything outside the region came from malloc
+class SlabRegion {
+    struct Slot { Slot * next; };
+    struct SizeClass {
+        size_t size;
+        Slot * free;
+    };
+
+    char * _base = nullptr;
+    size_t _bytes = 0;
+    size_t _carved = 0;
+    bool _mapped = false;
+    bool _huge = false;
+    std::vector<SizeClass> _classes;    // a handful – one per page size in use
+    int64_t _in_use = 0;
+    int64_t _overflow = 0;
+    std::mutex _lock;
+
+public:
+    bool reserve(size_t bytes, bool huge) {
+#ifdef BW_PCACHE_MMAP
+#ifdef MAP_HUGETLB
+        if(huge) {
+            size_t rounded = (bytes + (2u << 20) - 1) & ~(size_t) ((2u << 20) - 1);
+            void * p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if(p != MAP_FAILED) {
+                _base = (char *) p;
+                _bytes = rounded;
+                _mapped = true;
+                _huge = true;
+                return true;
+            }
+        }
+#endif
+        void * p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+        if(p != MAP_FAILED) {
+            _base = (char *) p;
+            _bytes = bytes;
+            _mapped = true;
+            return true;
+        }
+#endif
+        _base = (char *) malloc(bytes);
+        _bytes = _base ? bytes : 0;
+        return _base != nullptr;
+    }
+
+    // nullptr when the region is used up
+    void * alloc(size_t size) {
+        std::lock_guard<std::mutex> guard(_lock);
+        SizeClass * sc = _class(size);
+        if(!sc->free && !_carve(sc)) {
+            return nullptr;
+        }
+        Slot * slot = sc->free;
+        sc->free = slot->next;
+        ++_in_use;
+        return slot;
+    }
+
+    void * alloc_overflow(size_t size) {
+        void * p = malloc(size);
+        if(p) {
+            std::lock_guard<std::mutex> guard(_lock);
+            ++_overflow;
+        }
+        return p;
+    }
+
+    void free(void * p, size_t size) {
+        if(!p) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(_lock);
+        if((char *) p >= _base && (char *) p < _base + _bytes) {
+            SizeClass * sc = _class(size);
+            Slot * slot = (Slot *) p;
+            slot->next = sc->free;
+            sc->free = slot;
+            --_in_use;
+        } else {
+            --_overflow;
+            ::free(p);
+        }
+    }
+
+    BWSlabStats stats() {
+        std::lock_guard<std::mutex> guard(_lock);
+        BWSlabStats s;
+        s.bytes = (int64_t) _bytes;
+        s.carved = (int64_t) _carved;
+        s.slots_in_use = _in_use;
+        s.overflow = _overflow;
+        s.huge_pages = _huge;
+        return s;
+    }
+
+private:
+    // caller holds _lock
+    SizeClass * _class(size_t size) {
+        for(SizeClass & sc : _classes) {
+            if(sc.size == size) {
+                return &sc;
+            }
+        }
+        _classes.push_back({ size, nullptr });
+        return &_classes.back();
+    }
+
+    // caller holds _lock
+    bool _carve(SizeClass * sc) {
+        size_t chunk = std::max((size_t) DEFAULT_PCACHE_CHUNK, sc->size);
+        chunk = std::min(chunk, _bytes - _carved);
+        size_t count = chunk / sc->size;
+        if(!count) {
+            return false;
+        }
+        char * p = _base + _carved;
+        _carved += count * sc->size;
+        for(size_t i = 0; i < count; ++i) {
+            Slot * slot = (Slot *) (p + i * sc->size);
+            slot->next = sc->free;
+            sc->free = slot;
+        }
+        return true;
+    }
+};
+
+static SlabRegion region;
+static bool installed = false;
+
+// MARK: - cache
+
+// a slot is the page buffer, then sqlite's extra bytes, then this
+struct Page {
+    sqlite3_pcache_page base;
+    unsigned key;
+    bool pinned;
+    bool ref;                   // the clock bit, set on every fetch
+    size_t ring;                // index in Cache::ring
+    Page * next;                // hash chain
+};
+
+// sqlite calls a cache from one connection at a time, but another
+// cache may take its pages when the region runs out – lock is for that
+// the counters are atomic for the stats readers
+struct Cache {
+    int page_size;
+    int extra;
+    size_t slot;
+    bool purgeable;
+    unsigned max = 0;           // cache_size, in pages
+    std::vector<Page *> buckets;
+    std::vector<Page *> ring;
+    size_t hand = 0;
+    const void * owner;
+    std::mutex lock;
+    std::atomic<int64_t> hits { 0 };
+    std::atomic<int64_t> misses { 0 };
+    std::atomic<int64_t> evictions { 0 };
+    std::atomic<int64_t> overflow { 0 };
+    std::atomic<int64_t> pages { 0 };
+};
+
+static std::mutex caches_lock;
+static std::vector<Cache *> caches;
+static size_t steal_from = 0;           // round robin over caches, under caches_lock
+
+static inline void bump(std::atomic<int64_t> & counter, int64_t n = 1) {
+    counter.fetch_add(n, std::memory_order_relaxed);
+}
+
+static Page ** bucket_for(Cache * c, unsigned key) {
+    return &c->buckets[key & (c->buckets.size() - 1)];
+}
+
+static void hash_remove(Cache * c, Page * p) {
+    Page ** link = bucket_for(c, p->key);
+    while(*link && *link != p) {
+        link = &(*link)->next;
+    }
+    if(*link) {
+        *link = p->next;
+    }
+}
+
+static void hash_insert(Cache * c, Page * p) {
+    if(c->ring.size() >= c->buckets.size()) {
+        std::vector<Page *> old(c->buckets.size() * 2, nullptr);
+        old.swap(c->buckets);
+        for(Page * chain : old) {
+            while(chain) {
+                Page * next = chain->next;
+                Page ** bucket = bucket_for(c, chain->key);
+                chain->next = *bucket;
+                *bucket = chain;
+                chain = next;
+            }
+        }
+    }
+    Page ** bucket = bucket_for(c, p->key);
+    p->next = *bucket;
+    *bucket = p;
+}
+
+// out of the hash and the ring, memory still held
+static void detach(Cache * c, Page * p) {
+    hash_remove(c, p);
+    Page * last = c->ring.back();
+    c->ring[p->ring] = last;
+    last->ring = p->ring;
+    c->ring.pop_back();
+    if(c->hand >= c->ring.size()) {
+        c->hand = 0;
+    }
+    bump(c->pages, -1);
+}
+
+static void release(Cache * c, Page * p) {
+    detach(c, p);
+    region.free(p->base.pBuf, c->slot);
+}
+
+// clock – a page fetched since the hand last passed gets another turn
+// two sweeps find a victim if there is an unpinned page at all
+static Page * clock_victim(Cache * c) {
+    if(!c->purgeable) {
+        return nullptr;
+    }
+    size_t n = c->ring.size();
+    for(size_t i = 0; i < 2 * n; ++i) {
+        Page * p = c->ring[c->hand];
+        c->hand = (c->hand + 1) % n;
+        if(p->pinned) {
+            continue;
+        }
+        if(p->ref) {
+            p->ref = false;
+            continue;
+        }
+        detach(c, p);
+        bump(c->evictions);
+        return p;
+    }
+    return nullptr;
+}
+
+// the region is used up – take the clock's victim from another cache
+// with the same slot size, so the region stays the cap for all of them
+// c is locked, the others only tried – a busy cache is passed over
+static void * steal(Cache * c) {
+    std::lock_guard<std::mutex> guard(caches_lock);
+    size_t n = caches.size();
+    for(size_t i = 0; i < n; ++i) {
+        Cache * other = caches[(steal_from + i) % n];
+        if(other == c || other->slot != c->slot || !other->purgeable) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(other->lock, std::try_to_lock);
+        if(!lock.owns_lock()) {
+            continue;
+        }
+        Page * victim = clock_victim(other);
+        if(victim) {
+            steal_from = (steal_from + i + 1) % n;
+            return victim->base.pBuf;
+        }
+    }
+    return nullptr;
+}
+
+static Page * page_at(Cache * c, void * mem) {
+    return (Page *) ((char *) mem + c->slot - sizeof(Page));
+}
+
+// MARK: - pcache methods
+
+static int pc_init(void *) {
+    return SQLITE_OK;
+}
+
+static void pc_shutdown(void *) {}
+
+static sqlite3_pcache * pc_create(int page_size, int extra, int purgeable) {
+    Cache * c = new Cache();
+    c->page_size = page_size;
+    c->extra = extra;
+    c->slot = ((size_t) page_size + (size_t) extra + 7) & ~(size_t) 7;
+    c->slot += sizeof(Page);
+    c->purgeable = purgeable != 0;
+    c->buckets.assign(64, nullptr);
+    c->owner = pcache_owner;
+    std::lock_guard<std::mutex> guard(caches_lock);
+    caches.push_back(c);
+    return (sqlite3_pcache *) c;
+}
+
+static void pc_cachesize(sqlite3_pcache * pcache, int max) {
+    Cache * c = (Cache *) pcache;
+    std::lock_guard<std::mutex> guard(c->lock);
+    c->max = max > 0 ? (unsigned) max : 0;
+    while(c->max && c->ring.size() > c->max) {
+        Page * p = clock_victim(c);
+        if(!p) {
+            break;
+        }
+        region.free(p->base.pBuf, c->slot);
+    }
+}
+
+static int pc_pagecount(sqlite3_pcache * pcache) {
+    Cache * c = (Cache *) pcache;
+    std::lock_guard<std::mutex> guard(c->lock);
+    return (int) c->ring.size();
+}
+
+// create 0: only if it's here; 1: if it's cheap; 2: try hard
+static sqlite3_pcache_page * pc_fetch(sqlite3_pcache * pcache, unsigned key, int create) {
+    Cache * c = (Cache *) pcache;
+    std::lock_guard<std::mutex> guard(c->lock);
+    for(Page * p = *bucket_for(c, key); p; p = p->next) {
+        if(p->key == key) {
+            p->pinned = true;
+            p->ref = true;
+            bump(c->hits);
+            return &p->base;
+        }
+    }
+    if(!create) {
+        return nullptr;
+    }
+
+    void * mem = nullptr;
+    if(c->purgeable && c->max && c->ring.size() >= c->max) {
+        Page * victim = clock_victim(c);
+        if(victim) {
+            mem = victim->base.pBuf;
+        } else if(create == 1) {
+            return nullptr;
+        }
+    }
+    if(!mem) {
+        mem = region.alloc(c->slot);
+    }
+    if(!mem) {
+        Page * victim = clock_victim(c);
+        if(victim) {
+            mem = victim->base.pBuf;
+        } else {
+            mem = steal(c);
+        }
+    }
+    if(!mem && create == 2) {
+        // every page of this size is pinned
+        mem = region.alloc_overflow(c->slot);
+        if(mem) bump(c->overflow);
+    }
+    if(!mem) {
+        return nullptr;
+    }
+
+    Page * p = page_at(c, mem);
+    p->base.pBuf = mem;
+    p->base.pExtra = (char *) mem + c->page_size;
+    memset(p->base.pExtra, 0, (size_t) c->extra);      // sqlite looks for a zero here
+    p->key = key;
+    p->pinned = true;
+    p->ref = true;
+    hash_insert(c, p);
+    p->ring = c->ring.size();
+    c->ring.push_back(p);
+    bump(c->pages);
+    bump(c->misses);            // once per page brought in, not per probe
+    return &p->base;
+}
+
+static void pc_unpin(sqlite3_pcache * pcache, sqlite3_pcache_page * page, int discard) {
+    Cache * c = (Cache *) pcache;
+    std::lock_guard<std::mutex> guard(c->lock);
+    Page * p = page_at(c, page->pBuf);
+    p->pinned = false;
+    if(discard) {
+        release(c, p);
+    }
+}
+
+// a page already at new_key is unpinned, and goes
+static void pc_rekey(sqlite3_pcache * pcache, sqlite3_pcache_page * page, unsigned, unsigned new_key) {
+    Cache * c = (Cache *) pcache;
+    std::lock_guard<std::mutex> guard(c->lock);
+    Page * p = page_at(c, page->pBuf);
+    for(Page * q = *bucket_for(c, new_key); q; q = q->next) {
+        if(q->key == new_key && q != p) {
+            release(c, q);
+            break;
+        }
+    }
+    hash_remove(c, p);
+    p->key = new_key;
+    Page ** bucket = bucket_for(c, new_key);
+    p->next = *bucket;
+    *bucket = p;
+}
+
+// drop every page at or past limit
+static void pc_truncate(sqlite3_pcache * pcache, unsigned limit) {
+    Cache * c = (Cache *) pcache;
+    std::lock_guard<std::mutex> guard(c->lock);
+    for(size_t i = 0; i < c->ring.size();) {
+        Page * p = c->ring[i];
+        if(p->key >= limit) {
+            release(c, p);      // the last page moves into i
+        } else {
+            ++i;
+        }
+    }
+}
+
+static void pc_destroy(sqlite3_pcache * pcache) {
+    Cache * c = (Cache *) pcache;
+    {
+        std::lock_guard<std::mutex> guard(caches_lock);
+        caches.erase(std::remove(caches.begin(), caches.end(), c), caches.end());
+    }
+    for(Page * p : c->ring) {
+        region.free(p->base.pBuf, c->slot);
+    }
+    delete c;
+}
+
+static void pc_shrink(sqlite3_pcache * pcache) {
+    Cache * c = (Cache *) pcache;
+    std::lock_guard<std::mutex> guard(c->lock);
+    for(size_t i = 0; i < c->ring.size();) {
+        Page * p = c->ring[i];
+        if(!p->pinned) {
+            release(c, p);
+        } else {
+            ++i;
+        }
+    }
+}
+
+static const sqlite3_pcache_methods2 methods = {
+    1, nullptr, pc_init, pc_shutdown, pc_create, pc_cachesize, pc_pagecount, pc_fetch,
+    pc_unpin, pc_rekey, pc_truncate, pc_destroy, pc_shrink
+};
+
+// MARK: - functions
+
+// every connection must be closed – sqlite3_shutdown() requires it
+bool page_cache_install(int64_t bytes, bool huge_pages) {
+    if(installed) {
+        return true;
+    }
+    if(bytes <= 0 || !region.reserve((size_t) bytes, huge_pages)) {
+        printf("page_cache_install: cannot reserve %lld bytes\n", (long long) bytes);
+        return false;
+    }
+    sqlite3_shutdown();
+    int rc = sqlite3_config(SQLITE_CONFIG_PCACHE2, &methods);
+    if(rc != SQLITE_OK) {
+        printf("page_cache_install: %s\n", sqlite3_errstr(rc));
+    }
+    sqlite3_initialize();
+    installed = rc == SQLITE_OK;
+    return installed;
+}
+
+bool page_cache_installed() {
+    return installed;
+}
+
+static BWPageCacheStats collect(bool all, const void * owner) {
+    BWPageCacheStats s;
+    std::lock_guard<std::mutex> guard(caches_lock);
+    for(Cache * c : caches) {
+        if(!all && c->owner != owner) {
+            continue;
+        }
+        s.hits += c->hits.load(std::memory_order_relaxed);
+        s.misses += c->misses.load(std::memory_order_relaxed);
+        s.evictions += c->evictions.load(std::memory_order_relaxed);
+        s.overflow += c->overflow.load(std::memory_order_relaxed);
+        s.pages += c->pages.load(std::memory_order_relaxed);
+        ++s.caches;
+    }
+    return s;
+}
+
+// live caches only – a closed connection's counts go with it
+BWPageCacheStats page_cache_stats() {
+    return collect(true, nullptr);
+}
+
+BWPageCacheStats page_cache_stats(const void * owner) {
+    return collect(false, owner);
+}
+
+BWSlabStats page_cache_slab_stats() {
+    return region.stats();
+}
+
+}
@@ -0,0 +1,69 @@
+//  BWPageCache.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWPAGECACHE_H
+#define BWPAGECACHE_H
+
+#include <sqlite3.h>
+#include <sqlcpp.h>
+#include <cstdint>
+
+namespace bw {
+
+#define DEFAULT_PCACHE_BYTES (64ll << 20)   // the whole slab region
+#define DEFAULT_PCACHE_CHUNK (256 << 10)    // carved for one slot size at a time
+
+// one connection's caches, or all of them
+struct BWPageCacheStats {
+    int64_t hits = 0;
+    int64_t misses = 0;             // pages brought in – probes that find nothing don't count
+    int64_t evictions = 0;
+    int64_t pages = 0;              // in the cache now
+    int64_t overflow = 0;           // pages that went to malloc, the slabs were full
+    int caches = 0;
+};
+
+struct BWSlabStats {
+    int64_t bytes = 0;              // reserved up front
+    int64_t carved = 0;             // handed out to slot sizes so far
+    int64_t slots_in_use = 0;
+    int64_t overflow = 0;           // live malloc'd pages
+    bool huge_pages = false;
+};
+
+// a sqlite3_pcache_methods2 page cache on preallocated slabs
+// pages come from one region reserved at install – on huge pages if
+// asked and the system has them – split into chunks, each chunk into
+// slots of one size, freed slots reused; sqlite's pages cost no malloc
+// once the region is warm. each cache evicts with a clock sweep
+// when it reaches its cache_size; when the region runs out it evicts
+// its own pages, then another cache's of the same page size, so the
+// region caps them all – only a page needed while every page of its
+// size is pinned goes to malloc, counted as overflow
+// install before any connection is opened – it shuts sqlite down and
+// initializes it again with the new cache
+bool page_cache_install(int64_t bytes = DEFAULT_PCACHE_BYTES, bool huge_pages = false);
+bool page_cache_installed();
+BWPageCacheStats page_cache_stats();                        // every cache
+BWPageCacheStats page_cache_stats(const void * owner);      // one owner's
+BWSlabStats page_cache_slab_stats();
+
+// caches created while the scope is alive belong to owner – BWSQL
+// opens inside one, so its page_cache_stats() covers its main database
+// a cache created later (a temp database, a changed page size) has no owner
+class BWPageCacheOwner {
+    const void * _previous;
+
+public:
+    explicit BWPageCacheOwner(const void * owner);
+    ~BWPageCacheOwner();
+    static const void * current();
+
+    BWPageCacheOwner(const BWPageCacheOwner &)                = delete;
+    BWPageCacheOwner & operator = (const BWPageCacheOwner &)  = delete;
+};
+
+}
+
+#endif // BWPAGECACHE_H
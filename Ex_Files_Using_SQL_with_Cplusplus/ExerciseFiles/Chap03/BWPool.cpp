@@ -0,0 +1,209 @@
+//  BWPool.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWPool.h"
+#include <algorithm>
+
+namespace bw {
+
+// MARK: - constructors
+
+ConnectionPool::ConnectionPool(const char * filename, int num_readers)
+: _filename(filename)
+{
+    // the writer goes first, so the file exists and is in WAL mode
+    // before any read-only connection opens it
+    _writer.db = std::make_unique<BWSQL>(_filename.c_str(),
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX);
+    _writer.db->sql_do("PRAGMA journal_mode=WAL");
+    sqlite3_busy_timeout(_writer.db->db(), DEFAULT_POOL_BUSY_TIMEOUT);
+
+    if(num_readers < 1) {
+        num_readers = 1;
+    }
+    _readers.resize(num_readers);
+    for(Conn & conn : _readers) {
+        conn.db = std::make_unique<BWSQL>(_filename.c_str(),
+            SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX);
+        sqlite3_busy_timeout(conn.db->db(), DEFAULT_POOL_BUSY_TIMEOUT);
+    }
+    _stats.num_readers = num_readers;
+    _stats_start = clock::now();
+}
+
+// all leases must be returned before the pool is destroyed
+ConnectionPool::~ConnectionPool() {
+    _readers.clear();
+    _writer.db.reset();
+}
+
+// MARK: - leases
+
+ConnectionPool::Lease ConnectionPool::reader(int timeout_ms) {
+    return Lease(this, _acquire(false, timeout_ms), false);
+}
+
+ConnectionPool::Lease ConnectionPool::writer(int timeout_ms) {
+    return Lease(this, _acquire(true, timeout_ms), true);
+}
+
+ConnectionPool::Lease::Lease(ConnectionPool * pool, Conn * conn, bool writer)
+: _pool(conn ? pool : nullptr), _conn(conn), _writer(writer) {}
+
+ConnectionPool::Lease::~Lease() {
+    release();
+}
+
+ConnectionPool::Lease::Lease(Lease && other) noexcept
+: _pool(other._pool), _conn(other._conn), _writer(other._writer)
+{
+    other._pool = nullptr;
+    other._conn = nullptr;
+}
+
+ConnectionPool::Lease & ConnectionPool::Lease::operator = (Lease && other) noexcept {
+    if(this != &other) {
+        release();
+        _pool = other._pool;
+        _conn = other._conn;
+        _writer = other._writer;
+        other._pool = nullptr;
+        other._conn = nullptr;
+    }
+    return *this;
+}
+
+BWSQL * ConnectionPool::Lease::operator -> () const {
+    return get();
+}
+
+BWSQL & ConnectionPool::Lease::operator * () const {
+    return *get();
+}
+
+BWSQL * ConnectionPool::Lease::get() const {
+    return _conn ? _conn->db.get() : nullptr;
+}
+
+ConnectionPool::Lease::operator bool() const {
+    return _conn != nullptr;
+}
+
+// back to the pool, any open statement is reset first
+void ConnectionPool::Lease::release() {
+    if(_pool && _conn) {
+        _conn->db->reset_stmt();
+        _pool->_release(_conn, _writer);
+    }
+    _pool = nullptr;
+    _conn = nullptr;
+}
+
+// MARK: - utilities
+
+PoolStats ConnectionPool::stats() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    PoolStats s = _stats;
+    clock::time_point now = clock::now();
+    s.elapsed_ms = _ms(now - _stats_start);
+
+    // count the time of leases still outstanding
+    s.readers_in_use = 0;
+    for(const Conn & conn : _readers) {
+        if(conn.in_use) {
+            ++s.readers_in_use;
+            s.readers.busy_ms += _ms(now - std::max(conn.since, _stats_start));
+        }
+    }
+    s.writer_in_use = _writer.in_use;
+    if(_writer.in_use) {
+        s.writer.busy_ms += _ms(now - std::max(_writer.since, _stats_start));
+    }
+
+    if(s.elapsed_ms > 0) {
+        s.readers.utilization = s.readers.busy_ms / (s.elapsed_ms * (double) _readers.size());
+        s.writer.utilization = s.writer.busy_ms / s.elapsed_ms;
+    }
+    return s;
+}
+
+void ConnectionPool::reset_stats() {
+    std::lock_guard<std::mutex> guard(_lock);
+    _stats.readers = PoolRoleStats();
+    _stats.writer = PoolRoleStats();
+    _stats_start = clock::now();
+}
+
+const char * ConnectionPool::filename() const {
+    return _filename.c_str();
+}
+
+int ConnectionPool::num_readers() const {
+    return (int) _readers.size();
+}
+
+// MARK: - private
+
+ConnectionPool::Conn * ConnectionPool::_acquire(bool writer, int timeout_ms) {
+    std::unique_lock<std::mutex> lock(_lock);
+    PoolRoleStats & rs = writer ? _stats.writer : _stats.readers;
+    std::condition_variable & cv = writer ? _writer_cv : _reader_cv;
+    clock::time_point start = clock::now();
+
+    auto find_free = [&]() -> Conn * {
+        if(writer) {
+            return _writer.in_use ? nullptr : &_writer;
+        }
+        for(Conn & conn : _readers) {
+            if(!conn.in_use) return &conn;
+        }
+        return nullptr;
+    };
+
+    Conn * conn = find_free();
+    if(!conn) {
+        ++rs.waits;
+        if(timeout_ms < 0) {
+            cv.wait(lock, [&] { return (conn = find_free()) != nullptr; });
+        } else {
+            cv.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                        [&] { return (conn = find_free()) != nullptr; });
+        }
+    }
+
+    clock::time_point now = clock::now();
+    double wait_ms = _ms(now - start);
+    rs.wait_ms_total += wait_ms;
+    if(wait_ms > rs.wait_ms_max) {
+        rs.wait_ms_max = wait_ms;
+    }
+    if(!conn) {
+        ++rs.timeouts;
+        return nullptr;
+    }
+    ++rs.acquisitions;
+    conn->in_use = true;
+    conn->since = now;
+    return conn;
+}
+
+void ConnectionPool::_release(Conn * conn, bool writer) {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        PoolRoleStats & rs = writer ? _stats.writer : _stats.readers;
+        rs.busy_ms += _ms(clock::now() - std::max(conn->since, _stats_start));
+        conn->in_use = false;
+    }
+    if(writer) {
+        _writer_cv.notify_one();
+    } else {
+        _reader_cv.notify_one();
+    }
+}
+
+double ConnectionPool::_ms(clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+}
@@ -0,0 +1,109 @@
+//  BWPool.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWPOOL_H
+#define BWPOOL_H
+
+#include "BWSQL.h"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bw {
+
+#define DEFAULT_POOL_BUSY_TIMEOUT 5000      // ms
+
+struct PoolRoleStats {
+    uint64_t acquisitions = 0;
+    uint64_t waits = 0;             // acquisitions that had to wait
+    uint64_t timeouts = 0;
+    double wait_ms_total = 0;
+    double wait_ms_max = 0;
+    double busy_ms = 0;             // time connections spent leased
+    double utilization = 0;         // busy_ms / (elapsed_ms * connections)
+};
+
+struct PoolStats {
+    PoolRoleStats readers;
+    PoolRoleStats writer;
+    int num_readers = 0;
+    int readers_in_use = 0;
+    bool writer_in_use = false;
+    double elapsed_ms = 0;          // since construction or reset_stats()
+};
+
+// N read-only connections plus one writer on the same database file
+// the database is put in WAL mode so readers run alongside the writer
+// each connection is used by one thread at a time, through a Lease
+class ConnectionPool {
+    using clock = std::chrono::steady_clock;
+
+    struct Conn {
+        std::unique_ptr<BWSQL> db;
+        bool in_use = false;
+        clock::time_point since;
+    };
+
+    std::string _filename;
+    std::vector<Conn> _readers;
+    Conn _writer;
+    mutable std::mutex _lock;
+    std::condition_variable _reader_cv;
+    std::condition_variable _writer_cv;
+    PoolStats _stats;
+    clock::time_point _stats_start;
+
+public:
+    // a connection on loan from the pool, returned when destroyed
+    class Lease {
+        ConnectionPool * _pool = nullptr;
+        Conn * _conn = nullptr;
+        bool _writer = false;
+
+    public:
+        Lease() = default;
+        Lease(ConnectionPool * pool, Conn * conn, bool writer);
+        ~Lease();
+
+        BWSQL * operator -> () const;
+        BWSQL & operator * () const;
+        BWSQL * get() const;
+        explicit operator bool() const;
+        void release();
+
+        Lease(const Lease &)                = delete;
+        Lease & operator = (const Lease &)  = delete;
+        Lease(Lease && other) noexcept;
+        Lease & operator = (Lease && other) noexcept;
+    };
+
+    // ctor/dtor
+    ConnectionPool(const char * filename, int num_readers);
+    ~ConnectionPool();
+
+    // timeout_ms < 0 waits forever, an empty lease means timed out
+    Lease reader(int timeout_ms = -1);
+    Lease writer(int timeout_ms = -1);
+
+    // utilities
+    PoolStats stats() const;
+    void reset_stats();
+    const char * filename() const;
+    int num_readers() const;
+
+    ConnectionPool(const ConnectionPool &)                = delete;
+    ConnectionPool & operator = (const ConnectionPool &)  = delete;
+
+private:
+    Conn * _acquire(bool writer, int timeout_ms);
+    void _release(Conn * conn, bool writer);
+    static double _ms(clock::duration d);
+};
+
+}
+
+#endif // BWPOOL_H
@@ -0,0 +1,109 @@
+//  BWRowView.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWROWVIEW_H
+#define BWROWVIEW_H
+
+#include <sqlite3.h>
+#include "BWBind.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+namespace bw {
+
+// typed, zero-copy view of the current row of a statement
+// values come straight from sqlite3_column_*, nothing is copied
+// a view (and any string_view or blob from it) is only valid
+// until the statement is stepped or reset
+class RowView {
+    sqlite3_stmt * _stmt = nullptr;
+
+public:
+    RowView() = default;
+    explicit RowView(sqlite3_stmt * stmt) : _stmt(stmt) {}
+
+    // false at the end of the result set
+    explicit operator bool() const { return _stmt != nullptr; }
+
+    int num_columns() const { return _stmt ? sqlite3_column_count(_stmt) : 0; }
+    int type(int col) const { return sqlite3_column_type(_stmt, col); }
+    bool is_null(int col) const { return type(col) == SQLITE_NULL; }
+    const char * name(int col) const { return sqlite3_column_name(_stmt, col); }
+    sqlite3_stmt * stmt() const { return _stmt; }
+
+    // get<int64_t>, get<double>, get<std::string_view>, get<blob> ...
+    template<typename T> T get(int col) const;
+};
+
+template<typename T>
+T RowView::get(int col) const {
+    if constexpr(std::is_same_v<T, bool>) {
+        return sqlite3_column_int64(_stmt, col) != 0;
+    } else if constexpr(std::is_integral_v<T>) {
+        return (T) sqlite3_column_int64(_stmt, col);
+    } else if constexpr(std::is_floating_point_v<T>) {
+        return (T) sqlite3_column_double(_stmt, col);
+    } else if constexpr(std::is_same_v<T, std::string_view>) {
+        // text first, then bytes – see sqlite.org/c3ref/column_blob.html
+        const char * text = (const char *) sqlite3_column_text(_stmt, col);
+        if(!text) {
+            return std::string_view();
+        }
+        return std::string_view(text, (size_t) sqlite3_column_bytes(_stmt, col));
+    } else if constexpr(std::is_same_v<T, const char *>) {
+        return (const char *) sqlite3_column_text(_stmt, col);
+    } else if constexpr(std::is_same_v<T, blob>) {
+        const void * data = sqlite3_column_blob(_stmt, col);
+        return blob{ data, sqlite3_column_bytes(_stmt, col) };
+    } else {
+        static_assert(!sizeof(T), "RowView::get: unsupported type");
+    }
+}
+
+// MARK: - range-for over a statement
+
+// Source is anything with RowView fetch_view() – BWSQL or Statement
+// for(RowView row : db.rows()) { ... }
+template<typename Source>
+class RowIterator {
+    Source * _src = nullptr;
+    RowView _row;
+
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = RowView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const RowView *;
+    using reference = const RowView &;
+
+    RowIterator() = default;
+    explicit RowIterator(Source * src) : _src(src), _row(src->fetch_view()) {}
+
+    const RowView & operator * () const { return _row; }
+    const RowView * operator -> () const { return &_row; }
+    RowIterator & operator ++ () {
+        _row = _src->fetch_view();
+        return *this;
+    }
+    // only the end of the result set compares equal to end()
+    bool operator == (const RowIterator & other) const { return (bool) _row == (bool) other._row; }
+    bool operator != (const RowIterator & other) const { return !(*this == other); }
+};
+
+template<typename Source>
+class RowRange {
+    Source * _src;
+
+public:
+    explicit RowRange(Source * src) : _src(src) {}
+    RowIterator<Source> begin() const { return RowIterator<Source>(_src); }
+    RowIterator<Source> end() const { return RowIterator<Source>(); }
+};
+
+}
+
+#endif // BWROWVIEW_H
@@ -8,9 +8,20 @@ namespace bw {
 
 // MARK: - constructors
 
-void BWSQL::_init() {
+// the profile's settings are applied before anything else uses the connection
+// a URI profile opens "file:<filename>?<params>" – filename() stays the plain path
+void BWSQL::_init(const OpenProfile * profile) {
     reset();
-    int rc = sqlite3_open(_filename, &_db);
+    BWPageCacheOwner owner(this);       // the main database's page cache is ours
+    int rc = SQLITE_OK;
+    if(profile) {
+        // a setting that fails is reported, the connection is still usable
+        if(open_with_profile(_filename, &_db, *profile, &rc) != SQLITE_OK && rc == SQLITE_OK) {
+            printf("profile %s not fully applied\n", profile->name);
+        }
+    } else {
+        rc = sqlite3_open_v2(_filename, &_db, _flags, nullptr);
+    }
     if(rc) {
         error("sqlite_open");
     }
@@ -26,18 +37,51 @@ BWSQL::BWSQL(const char * filename)
     _init();
 }
 
+BWSQL::BWSQL(const char * filename, int flags)
+:_filename(filename), _flags(flags)
+{
+    _init();
+}
+
+BWSQL::BWSQL(const char * filename, const OpenProfile & profile)
+:_filename(filename), _flags(profile.flags)
+{
+    _init(&profile);
+}
+
 // MARK: - sql methods
 // all va_args are const char *
+// typed parameters use the templates in BWSQL.h
 
-int BWSQL::_sql_prepare(const char * sql, va_list ap) {
+// replaces the current statement with one for sql
+bool BWSQL::_prepare_stmt(const char * sql) {
     reset_stmt();
-    int rc = sqlite3_prepare_v2(_db, sql, -1, &_stmt, nullptr);
+    int rc = SQLITE_OK;
+    _stmt = _stmt_cache.acquire(_db, sql, &rc);
     if(rc) {
         error_msg("sql_prepare");
         reset_stmt();
-        return 0;
+        return false;
     }
     _num_sql_columns = sqlite3_column_count(_stmt);
+    _stmt_op = BWTraceScope::current();
+    return true;
+}
+
+// every step of the current statement goes through here, for the profile
+// rows fetched after get_rows() returns still count as get_rows
+int BWSQL::_step() {
+    if(!_stmt_op) {
+        return _profiler.step(_stmt);
+    }
+    BWTraceScope scope(_stmt_op);
+    return _profiler.step(_stmt);
+}
+
+int BWSQL::_sql_prepare(const char * sql, va_list ap) {
+    if(!_prepare_stmt(sql)) {
+        return 0;
+    }
     int col_count = sqlite3_bind_parameter_count(_stmt);
     if(col_count) {
         for(int param_no = 1; param_no <= col_count; ++param_no) {     // params start at 1
@@ -61,7 +105,7 @@ int BWSQL::sql_do(const char * sql, ...) {
     va_start(ap, sql);
     _sql_prepare(sql, ap);
     va_end(ap);
-    sqlite3_step(_stmt);
+    _step();
     reset_stmt();
     return sqlite3_changes(_db);
 }
@@ -86,13 +130,13 @@ const char ** BWSQL::fetch_row() {
         return nullptr;
     }
     // get the next row, if avail
-    if(sqlite3_step(_stmt) != SQLITE_ROW) {
+    if(_step() != SQLITE_ROW) {
         reset_stmt();
         return nullptr;
     }
     // make sure we have allocated space
     if(_num_sql_columns && !_row) {
-        _row = new const char * [_num_sql_columns];
+        _row = _arena.alloc_array<const char *>(_num_sql_columns);
     }
     for(int index = 0; index < _num_sql_columns; ++index) {
         _row[index] = (const char *) sqlite3_column_text(_stmt, index);
@@ -100,13 +144,47 @@ const char ** BWSQL::fetch_row() {
     return _row;
 }
 
+// typed alternative to fetch_row()
+// the view is valid until the next fetch or reset
+RowView BWSQL::fetch_view() {
+    if(!_stmt) {
+        reset_stmt();
+        return RowView();
+    }
+    if(_step() != SQLITE_ROW) {
+        reset_stmt();
+        return RowView();
+    }
+    return RowView(_stmt);
+}
+
+// range-for over the current statement
+RowRange<BWSQL> BWSQL::rows() {
+    return RowRange<BWSQL>(this);
+}
+
+// up to max_rows rows into batch, column by column
+// returns the number of rows, 0 at the end
+int BWSQL::fetch_batch(ColumnBatch & batch, int max_rows) {
+    bool done = false;
+    _profiler.begin(_stmt);
+    auto start = std::chrono::steady_clock::now();
+    int count = batch.fill(_stmt, max_rows, &done);
+    _profiler.add(_stmt, (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count(), (uint64_t) count);
+    if(done) {
+        reset_stmt();
+    }
+    return count;
+}
+
 const char ** BWSQL::sql_column_names() {
     if(!_stmt) {
         reset_stmt();
         return nullptr;
     }
     if(_num_sql_columns && !_sql_colnames) {
-        _sql_colnames = new const char * [_num_sql_columns];
+        _sql_colnames = _arena.alloc_array<const char *>(_num_sql_columns);
     }
     for(int index = 0; index < _num_sql_columns; ++index) {
         _sql_colnames[index] = (const char *) sqlite3_column_name(_stmt, index);
@@ -145,25 +223,41 @@ int BWSQL::num_params(const char * sql) {
 }
 
 void BWSQL::reset_stmt() {
-    _num_sql_columns = 0;
     if(_stmt) {
-        sqlite3_finalize(_stmt);
+        // back to the cache, reset and unbound
+        _profiler.end(_stmt);
+        _stmt_cache.release(_stmt);
         _stmt = nullptr;
+        _stmt_op = nullptr;
     }
+    // buffers go back to the arena for the next statement
     if(_row) {
-        delete [] _row;
+        _arena.dealloc_array(_row, _num_sql_columns);
         _row = nullptr;
     }
     if(_sql_colnames) {
-        delete [] _sql_colnames;
+        _arena.dealloc_array(_sql_colnames, _num_sql_columns);
         _sql_colnames = nullptr;
     }
+    _num_sql_columns = 0;
 }
 
 void BWSQL::reset() {
     reset_stmt();
+    _stmt_cache.clear();
     if(_db) {
-        sqlite3_close(_db);
+        // a Statement still alive keeps the connection open until it's
+        // released – its close event would come after the detach
+        if(_tracer && sqlite3_next_stmt(_db, nullptr)) {
+            sqlite3_trace_v2(_db, 0, nullptr, nullptr);
+        }
+        sqlite3_close_v2(_db);
+        if(_tracer) {
+            _tracer->detach(_trace_conn);   // after the close event
+            _tracer = nullptr;
+            _trace_conn = nullptr;
+            _stmt_cache.tracer(nullptr);
+        }
         _db = nullptr;
     }
 }
@@ -200,4 +294,120 @@ sqlite3_stmt * BWSQL::stmt()const {
     return _stmt;
 }
 
+// MARK: - statement cache
+
+BWStmtCacheStats BWSQL::stmt_cache_stats() const {
+    return _stmt_cache.stats();
+}
+
+// 0 disables the cache
+void BWSQL::stmt_cache_size(int capacity) {
+    reset_stmt();
+    _stmt_cache.resize(capacity);
+}
+
+// MARK: - buffer arena
+
+BWArena & BWSQL::arena() {
+    return _arena;
+}
+
+BWArenaStats BWSQL::arena_stats() const {
+    return _arena.stats();
+}
+
+// MARK: - statement profile
+
+// runs still in progress aren't counted yet
+std::vector<BWStmtStats> BWSQL::stmt_stats() {
+    return _profiler.snapshot();
+}
+
+void BWSQL::reset_stmt_stats() {
+    _profiler.reset();
+}
+
+// off by default – slow_log() turns it on too
+void BWSQL::stmt_profiling(bool on) {
+    _profiler.enable(on);
+}
+
+// executions over the log's threshold are logged
+// the log is not owned and may be shared, nullptr turns it off
+void BWSQL::slow_log(BWSlowLog * log) {
+    _profiler.slow_log(log);
+}
+
+// MARK: - memory status
+
+// reset zeroes the cache hit/miss/write counters
+BWDbStatus BWSQL::db_status(bool reset) {
+    return sqlite_db_status(_db, reset);
+}
+
+// process wide, all connections
+BWMemStatus BWSQL::mem_status(bool reset) {
+    return sqlite_mem_status(reset);
+}
+
+// MARK: - I/O
+
+// this database file with its -wal and -journal, every connection
+// opened through BW_VFS_NAME – zero for any other vfs
+BWIoStats BWSQL::io_stats() {
+    BWIoStats s;
+    const char * path = _db ? sqlite3_db_filename(_db, "main") : nullptr;
+    if(!path || !*path) {
+        return s;
+    }
+    std::string name = path;
+    s += io_vfs_file_stats(name.c_str());
+    s += io_vfs_file_stats((name + "-wal").c_str());
+    s += io_vfs_file_stats((name + "-journal").c_str());
+    return s;
+}
+
+// MARK: - page cache
+
+// counters of this connection's caches in the page cache from
+// page_cache_install() – zero with sqlite's own
+BWPageCacheStats BWSQL::page_cache_stats() {
+    return bw::page_cache_stats(this);
+}
+
+// MARK: - backup
+
+// wait() on the result for the outcome, or drop it to cancel
+// on_progress and max_restarts are set before it starts
+std::unique_ptr<BWBackup> BWSQL::backup(const char * dest, int pages, int yield_ms,
+                                        std::function<void(const BWBackupProgress &)> on_progress,
+                                        int max_restarts) {
+    auto b = std::make_unique<BWBackup>(_db, dest, pages, yield_ms);
+    b->on_progress(std::move(on_progress));
+    b->max_restarts(max_restarts);
+    if(!b->start()) {
+        printf("BWSQL backup: cannot start %s\n", dest ? dest : "(null)");
+    }
+    return b;
+}
+
+// MARK: - tracing
+
+// the tracer is not owned and may be shared
+// it must outlive the connection, or be turned off with nullptr
+bool BWSQL::trace(BWTracer * tracer, unsigned mask) {
+    if(_tracer) {
+        sqlite3_trace_v2(_db, 0, nullptr, nullptr);
+        _tracer->detach(_trace_conn);
+        _trace_conn = nullptr;
+    }
+    _tracer = tracer;
+    _stmt_cache.tracer(tracer);
+    if(!tracer) {
+        return true;
+    }
+    _trace_conn = tracer->attach(_db, mask, _filename);
+    return _trace_conn != nullptr;
+}
+
 }
@@ -7,6 +7,20 @@
 
 #include <sqlite3.h>
 #include <sqlcpp.h>
+#include "BWStmtCache.h"
+#include "BWStmtStats.h"
+#include "BWSlowLog.h"
+#include "BWTrace.h"
+#include "BWStatus.h"
+#include "BWOpenProfile.h"
+#include "BWVfs.h"
+#include "BWBackup.h"
+#include "BWPageCache.h"
+#include "BWArena.h"
+#include "BWBind.h"
+#include "BWRowView.h"
+#include "BWStatement.h"
+#include "BWColumns.h"
 #include <cstdio>
 #include <cstdlib>
 #include <cstdarg>
@@ -18,15 +32,26 @@ namespace bw {
 
 class BWSQL {
     const char * _filename = nullptr;
+    int _flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
     sqlite3 * _db = nullptr;
     sqlite3_stmt * _stmt = nullptr;
     int _num_sql_columns = 0;
     const char ** _sql_colnames = nullptr;
     const char ** _row =  nullptr;
+    BWArena _arena;
+    BWStmtCache _stmt_cache;
+    BWStmtProfiler _profiler;
+    BWTracer * _tracer = nullptr;
+    BWTracer::Conn * _trace_conn = nullptr;
+    const char * _stmt_op = nullptr;    // BWTraceScope tag when the statement was prepared
+
+    friend class Statement;     // shares the statement cache, arena and profiler
 
 public:
     // ctor/dtor
     BWSQL(const char * filename);
+    BWSQL(const char * filename, int flags);    // sqlite3_open_v2 flags
+    BWSQL(const char * filename, const OpenProfile & profile);
     ~BWSQL();
 
     // sql methods
@@ -34,9 +59,25 @@ public:
     int sql_do(const char * sql, ...);
     const char * sql_value(const char * sql, ...);
     const char ** fetch_row();
+    RowView fetch_view();
+    RowRange<BWSQL> rows();
+    int fetch_batch(ColumnBatch & batch, int max_rows = DEFAULT_BATCH_ROWS);
     const char ** sql_column_names();
     int num_sql_columns() const;
 
+    // typed parameters, bound with the matching sqlite3_bind_* call
+    template<typename... Args> int sql_prepare(const char * sql, Args &&... args);
+    template<typename... Args> int sql_do(const char * sql, Args &&... args);
+    template<typename... Args> const char * sql_value(const char * sql, Args &&... args);
+
+    // BW_SQL() constants, parameter count checked at compile time
+    template<int N, typename... Args> int sql_prepare(sql_const<N> sql, Args &&... args);
+    template<int N, typename... Args> int sql_do(sql_const<N> sql, Args &&... args);
+    template<int N, typename... Args> const char * sql_value(sql_const<N> sql, Args &&... args);
+
+    // independent cursors on this connection
+    template<typename... Args> Statement statement(const char * sql, Args &&... args);
+
     // utilities
     const char * version() const;
     const char * sqlite_version();
@@ -49,6 +90,39 @@ public:
     sqlite3 * db() const;
     sqlite3_stmt * stmt() const;
 
+    // statement cache
+    BWStmtCacheStats stmt_cache_stats() const;
+    void stmt_cache_size(int capacity);
+
+    // buffer arena
+    BWArena & arena();
+    BWArenaStats arena_stats() const;
+
+    // per-statement profile, most total time first
+    std::vector<BWStmtStats> stmt_stats();
+    void reset_stmt_stats();
+    void stmt_profiling(bool on);
+    void slow_log(BWSlowLog * log);
+
+    // memory and page cache
+    BWDbStatus db_status(bool reset = false);
+    static BWMemStatus mem_status(bool reset = false);
+
+    // file I/O through the counting vfs, see BWVfs.h
+    BWIoStats io_stats();
+
+    // hits and misses in the slab page cache, see BWPageCache.h
+    BWPageCacheStats page_cache_stats();
+
+    // online backup on a background thread, already started
+    std::unique_ptr<BWBackup> backup(const char * dest, int pages = DEFAULT_BACKUP_PAGES,
+                                     int yield_ms = DEFAULT_BACKUP_YIELD_MS,
+                                     std::function<void(const BWBackupProgress &)> on_progress = nullptr,
+                                     int max_restarts = DEFAULT_BACKUP_MAX_RESTARTS);
+
+    // Chrome trace events, opt-in
+    bool trace(BWTracer * tracer, unsigned mask = BW_TRACE_ALL);
+
     // rule of five stuff
     BWSQL()                     = delete;   // no default constructor
     BWSQL(const BWSQL &)        = delete;   // no copy
@@ -56,12 +130,87 @@ public:
     BWSQL(BWSQL &&)             = delete;   // no move
 
 private:
-    void _init();
+    void _init(const OpenProfile * profile = nullptr);
 
 protected:
+    bool _prepare_stmt(const char * sql);
+    int _step();
     int _sql_prepare(const char * sql, va_list ap);
+    template<typename... Args> int _sql_bind_prepare(const char * sql, Args &&... args);
 };
 
+// MARK: - typed parameter templates
+
+template<typename... Args>
+int BWSQL::_sql_bind_prepare(const char * sql, Args &&... args) {
+    if(!_prepare_stmt(sql)) {
+        return 0;
+    }
+    int param_count = sqlite3_bind_parameter_count(_stmt);
+    if(param_count != (int) sizeof...(Args)) {
+        printf("sql_prepare: %d parameters expected, %d given\n", param_count, (int) sizeof...(Args));
+        reset_stmt();
+        return 0;
+    }
+    if(bind_params(_stmt, std::forward<Args>(args)...)) {
+        error_msg("sql_bind");
+        reset_stmt();
+        return 0;
+    }
+    return param_count;
+}
+
+template<typename... Args>
+int BWSQL::sql_prepare(const char * sql, Args &&... args) {
+    _sql_bind_prepare(sql, std::forward<Args>(args)...);
+    return num_sql_columns();
+}
+
+template<typename... Args>
+int BWSQL::sql_do(const char * sql, Args &&... args) {
+    _sql_bind_prepare(sql, std::forward<Args>(args)...);
+    if(!_stmt) {
+        return 0;
+    }
+    _step();
+    reset_stmt();
+    return sqlite3_changes(_db);
+}
+
+template<typename... Args>
+const char * BWSQL::sql_value(const char * sql, Args &&... args) {
+    _sql_bind_prepare(sql, std::forward<Args>(args)...);
+    const char ** row = fetch_row();
+    return row ? row[0] : nullptr;
+}
+
+template<typename... Args>
+Statement BWSQL::statement(const char * sql, Args &&... args) {
+    Statement st(*this, sql);
+    if(st && (sizeof...(Args) || sqlite3_bind_parameter_count(st.stmt()))) {
+        st.bind(std::forward<Args>(args)...);
+    }
+    return st;
+}
+
+template<int N, typename... Args>
+int BWSQL::sql_prepare(sql_const<N> sql, Args &&... args) {
+    static_assert(N == sizeof...(Args), "sql_prepare: wrong number of bind parameters");
+    return sql_prepare(sql.str, std::forward<Args>(args)...);
+}
+
+template<int N, typename... Args>
+int BWSQL::sql_do(sql_const<N> sql, Args &&... args) {
+    static_assert(N == sizeof...(Args), "sql_do: wrong number of bind parameters");
+    return sql_do(sql.str, std::forward<Args>(args)...);
+}
+
+template<int N, typename... Args>
+const char * BWSQL::sql_value(sql_const<N> sql, Args &&... args) {
+    static_assert(N == sizeof...(Args), "sql_value: wrong number of bind parameters");
+    return sql_value(sql.str, std::forward<Args>(args)...);
+}
+
 }
 
 #endif // BWSQL_H
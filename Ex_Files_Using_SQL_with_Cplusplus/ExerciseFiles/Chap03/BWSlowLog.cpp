@@ -0,0 +1,194 @@
+//  BWSlowLog.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWSlowLog.h"
+#include <chrono>
+#include <ctime>
+
+namespace bw {
+
+// MARK: - constructors
+
+BWSlowLog::BWSlowLog(const char * path, double threshold_ms, long max_bytes, int keep)
+: _path(path), _threshold_ms(threshold_ms), _max_bytes(max_bytes), _keep(keep > 0 ? keep : 1) {}
+
+BWSlowLog::~BWSlowLog() {
+    if(_file) {
+        fclose(_file);
+    }
+    for(auto & [filename, side] : _side) {
+        sqlite3_close(side);
+    }
+}
+
+// MARK: - log methods
+
+bool BWSlowLog::is_slow(double ms) const {
+    return ms >= _threshold_ms.load(std::memory_order_relaxed);
+}
+
+// stmt must still have its bindings
+void BWSlowLog::record(sqlite3_stmt * stmt, const BWStmtStats & run) {
+    std::lock_guard<std::mutex> guard(_lock);
+    std::string plan = _plan(stmt);
+
+    // timestamp with milliseconds
+    auto now = std::chrono::system_clock::now();
+    time_t secs = std::chrono::system_clock::to_time_t(now);
+    int ms = (int) (std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000);
+    struct tm tm_now;
+    localtime_r(&secs, &tm_now);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm_now);
+
+    char * expanded = sqlite3_expanded_sql(stmt);
+    char * entry = sqlite3_mprintf(
+        "%s.%03d slow query %.3f ms, %llu rows\n"
+        "  sql: %s\n"
+        "  fullscan %llu, sort %llu, autoindex %llu, vm_step %llu, reprepare %llu, run %llu, memused %d\n"
+        "  plan:\n%s\n",
+        stamp, ms, run.total_ms, (unsigned long long) run.rows,
+        expanded ? expanded : sqlite3_sql(stmt),
+        (unsigned long long) run.fullscan_steps, (unsigned long long) run.sorts,
+        (unsigned long long) run.autoindexes, (unsigned long long) run.vm_steps,
+        (unsigned long long) run.reprepares, (unsigned long long) run.runs, run.memused,
+        plan.c_str());
+    sqlite3_free(expanded);
+    if(!entry) {
+        return;
+    }
+
+    long len = (long) strlen(entry);
+    if(_file && _size + len > _max_bytes) {
+        _rotate();
+    }
+    if(_file || _open()) {
+        fputs(entry, _file);
+        fflush(_file);
+        _size += len;
+        ++_logged;
+    }
+    sqlite3_free(entry);
+}
+
+// MARK: - utilities
+
+// 0 logs everything
+void BWSlowLog::threshold(double ms) {
+    _threshold_ms.store(ms, std::memory_order_relaxed);
+}
+
+double BWSlowLog::threshold() const {
+    return _threshold_ms.load(std::memory_order_relaxed);
+}
+
+uint64_t BWSlowLog::logged() {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _logged;
+}
+
+const char * BWSlowLog::path() const {
+    return _path.c_str();
+}
+
+// MARK: - private
+
+// EXPLAIN QUERY PLAN on a side connection, so the statement
+// and its connection are left alone
+// plans are kept by SQL text until the schema changes – a new index
+// shows up in the next entry; a failed EXPLAIN is kept the same way
+std::string BWSlowLog::_plan(sqlite3_stmt * stmt) {
+    const char * no_plan = "    (no plan for an in-memory database)";
+    const char * sql = sqlite3_sql(stmt);
+    const char * filename = sqlite3_db_filename(sqlite3_db_handle(stmt), "main");
+    if(!filename || !*filename) {
+        return no_plan;
+    }
+    sqlite3 *& side = _side[filename];
+    if(!side) {
+        if(sqlite3_open_v2(filename, &side, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr)) {
+            sqlite3_close(side);
+            side = nullptr;
+            _side.erase(filename);
+            return no_plan;
+        }
+    }
+
+    int schema_version = _schema_version(side);
+    std::string key = std::string(filename) + '\n' + sql;
+    auto it = _plans.find(key);
+    if(it != _plans.end() && it->second.schema_version == schema_version) {
+        return it->second.text;
+    }
+
+    // EXPLAIN QUERY PLAN never checks the schema cookie – a read of
+    // sqlite_schema does, and reloads the side connection's schema
+    sqlite3_exec(side, "SELECT 1 FROM sqlite_schema LIMIT 1", nullptr, nullptr, nullptr);
+    std::string eqp = std::string("EXPLAIN QUERY PLAN ") + sql;
+    sqlite3_stmt * plan_stmt = nullptr;
+    std::string text;
+    if(sqlite3_prepare_v2(side, eqp.c_str(), -1, &plan_stmt, nullptr) != SQLITE_OK || !plan_stmt) {
+        text = std::string("    (no plan: ") + sqlite3_errmsg(side) + ")";
+    } else {
+        // rows are id, parent, notused, detail – indent by depth
+        std::map<int, int> depth;
+        while(sqlite3_step(plan_stmt) == SQLITE_ROW) {
+            int id = sqlite3_column_int(plan_stmt, 0);
+            int parent = sqlite3_column_int(plan_stmt, 1);
+            int d = depth.count(parent) ? depth[parent] + 1 : 0;
+            depth[id] = d;
+            text += std::string(4 + 2 * (size_t) d, ' ');
+            text += (const char *) sqlite3_column_text(plan_stmt, 3);
+            text += '\n';
+        }
+        if(!text.empty()) {
+            text.pop_back();
+        }
+    }
+    sqlite3_finalize(plan_stmt);
+    Plan & plan = _plans[key];
+    plan.schema_version = schema_version;
+    plan.text = text;
+    return text;
+}
+
+// read from the file header, so it's current on the side connection
+int BWSlowLog::_schema_version(sqlite3 * db) {
+    sqlite3_stmt * stmt = nullptr;
+    int version = -1;
+    if(sqlite3_prepare_v2(db, "PRAGMA schema_version", -1, &stmt, nullptr) == SQLITE_OK
+       && sqlite3_step(stmt) == SQLITE_ROW) {
+        version = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return version;
+}
+
+bool BWSlowLog::_open() {
+    _file = fopen(_path.c_str(), "a");
+    if(!_file) {
+        printf("BWSlowLog: cannot open %s\n", _path.c_str());
+        return false;
+    }
+    fseek(_file, 0, SEEK_END);
+    _size = ftell(_file);
+    return true;
+}
+
+// log.keep is dropped, log.k becomes log.k+1, log becomes log.1
+void BWSlowLog::_rotate() {
+    fclose(_file);
+    _file = nullptr;
+    std::string last = _path + "." + std::to_string(_keep);
+    remove(last.c_str());
+    for(int k = _keep - 1; k >= 1; --k) {
+        std::string from = _path + "." + std::to_string(k);
+        std::string to = _path + "." + std::to_string(k + 1);
+        rename(from.c_str(), to.c_str());
+    }
+    rename(_path.c_str(), (_path + ".1").c_str());
+    _open();
+}
+
+}
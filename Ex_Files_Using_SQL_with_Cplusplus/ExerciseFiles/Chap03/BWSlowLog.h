@@ -0,0 +1,73 @@
+//  BWSlowLog.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWSLOWLOG_H
+#define BWSLOWLOG_H
+
+#include "BWStmtStats.h"
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace bw {
+
+#define DEFAULT_SLOWLOG_THRESHOLD_MS 100
+#define DEFAULT_SLOWLOG_MAX_BYTES (1024 * 1024)
+#define DEFAULT_SLOWLOG_KEEP 3
+
+// slow query log
+// an execution that takes longer than the threshold is written with its
+// SQL and bound values, time, rows, stmt_status counters, and the
+// EXPLAIN QUERY PLAN from a read-only side connection to the same file
+// log rotates at max_bytes: log, log.1 ... log.keep
+// one log may be shared by any number of connections
+class BWSlowLog {
+    std::string _path;
+    std::atomic<double> _threshold_ms;
+    long _max_bytes;
+    int _keep;
+    FILE * _file = nullptr;
+    long _size = 0;
+    uint64_t _logged = 0;
+    struct Plan {
+        int schema_version = 0;     // the plan is stale once this moves
+        std::string text;
+    };
+
+    std::map<std::string, sqlite3 *> _side;         // by database filename
+    std::map<std::string, Plan> _plans;             // by filename and SQL text
+    std::mutex _lock;
+
+public:
+    // ctor/dtor
+    BWSlowLog(const char * path, double threshold_ms = DEFAULT_SLOWLOG_THRESHOLD_MS,
+              long max_bytes = DEFAULT_SLOWLOG_MAX_BYTES, int keep = DEFAULT_SLOWLOG_KEEP);
+    ~BWSlowLog();
+
+    // log methods
+    bool is_slow(double ms) const;
+    void record(sqlite3_stmt * stmt, const BWStmtStats & run);
+
+    // utilities
+    void threshold(double ms);
+    double threshold() const;
+    uint64_t logged();
+    const char * path() const;
+
+    // rule of five stuff
+    BWSlowLog(const BWSlowLog &)                = delete;   // no copy
+    BWSlowLog & operator = (const BWSlowLog &)  = delete;   // no assignment
+
+private:
+    std::string _plan(sqlite3_stmt * stmt);
+    static int _schema_version(sqlite3 * db);
+    bool _open();
+    void _rotate();
+};
+
+}
+
+#endif // BWSLOWLOG_H
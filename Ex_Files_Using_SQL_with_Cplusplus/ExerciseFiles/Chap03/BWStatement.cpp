@@ -0,0 +1,189 @@
+//  BWStatement.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWStatement.h"
+#include "BWSQL.h"
+
+namespace bw {
+
+// MARK: - constructors
+
+Statement::Statement(BWSQL & db, const char * sql)
+: _db(&db)
+{
+    int rc = SQLITE_OK;
+    _stmt = db._stmt_cache.acquire(db.db(), sql, &rc);
+    if(rc) {
+        db.error_msg("Statement");
+        _stmt = nullptr;
+        return;
+    }
+    _num_columns = sqlite3_column_count(_stmt);
+}
+
+Statement::~Statement() {
+    _release();
+}
+
+Statement::Statement(Statement && other) noexcept
+: _db(other._db), _stmt(other._stmt), _num_columns(other._num_columns),
+  _row(other._row), _colnames(other._colnames)
+{
+    other._stmt = nullptr;
+    other._num_columns = 0;
+    other._row = nullptr;
+    other._colnames = nullptr;
+}
+
+Statement & Statement::operator = (Statement && other) noexcept {
+    if(this != &other) {
+        _release();
+        _db = other._db;
+        _stmt = other._stmt;
+        _num_columns = other._num_columns;
+        _row = other._row;
+        _colnames = other._colnames;
+        other._stmt = nullptr;
+        other._num_columns = 0;
+        other._row = nullptr;
+        other._colnames = nullptr;
+    }
+    return *this;
+}
+
+// MARK: - sql methods
+
+int Statement::step() {
+    if(!_stmt) {
+        return SQLITE_MISUSE;
+    }
+    return _db->_profiler.step(_stmt);
+}
+
+// run to completion, returns the number of rows changed
+int Statement::exec() {
+    if(!_stmt) {
+        return 0;
+    }
+    step();
+    sqlite3_reset(_stmt);
+    return sqlite3_changes(sqlite3_db_handle(_stmt));
+}
+
+// at the end of the result set the statement is reset,
+// ready to run again with the same bindings
+const char ** Statement::fetch_row() {
+    if(step() != SQLITE_ROW) {
+        reset();
+        return nullptr;
+    }
+    if(_num_columns && !_row) {
+        _row = _db->_arena.alloc_array<const char *>(_num_columns);
+    }
+    for(int index = 0; index < _num_columns; ++index) {
+        _row[index] = (const char *) sqlite3_column_text(_stmt, index);
+    }
+    return _row;
+}
+
+RowView Statement::fetch_view() {
+    if(step() != SQLITE_ROW) {
+        reset();
+        return RowView();
+    }
+    return RowView(_stmt);
+}
+
+// for(RowView row : st.rows()) { ... }
+RowRange<Statement> Statement::rows() & {
+    return RowRange<Statement>(this);
+}
+
+// up to max_rows rows into batch, column by column
+// returns the number of rows, 0 at the end
+int Statement::fetch_batch(ColumnBatch & batch, int max_rows) {
+    bool done = false;
+    _db->_profiler.begin(_stmt);
+    auto start = std::chrono::steady_clock::now();
+    int count = batch.fill(_stmt, max_rows, &done);
+    _db->_profiler.add(_stmt, (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count(), (uint64_t) count);
+    if(done) {
+        reset();
+    }
+    return count;
+}
+
+const char ** Statement::column_names() {
+    if(!_stmt) {
+        return nullptr;
+    }
+    if(_num_columns && !_colnames) {
+        _colnames = _db->_arena.alloc_array<const char *>(_num_columns);
+    }
+    for(int index = 0; index < _num_columns; ++index) {
+        _colnames[index] = (const char *) sqlite3_column_name(_stmt, index);
+    }
+    return _colnames;
+}
+
+int Statement::num_columns() const {
+    return _num_columns;
+}
+
+// bindings are kept – use bind() to replace them
+void Statement::reset() {
+    if(_stmt) {
+        _end_run();
+        sqlite3_reset(_stmt);
+    }
+}
+
+// MARK: - utilities
+
+bool Statement::valid() const {
+    return _stmt != nullptr;
+}
+
+Statement::operator bool() const {
+    return valid();
+}
+
+const char * Statement::sql() const {
+    return _stmt ? sqlite3_sql(_stmt) : nullptr;
+}
+
+sqlite3_stmt * Statement::stmt() const {
+    return _stmt;
+}
+
+BWSQL * Statement::connection() const {
+    return _db;
+}
+
+// MARK: - private
+
+void Statement::_release() {
+    if(_stmt) {
+        _end_run();
+        _db->_stmt_cache.release(_stmt);
+        _stmt = nullptr;
+    }
+    if(_row) {
+        _db->_arena.dealloc_array(_row, _num_columns);
+        _row = nullptr;
+    }
+    if(_colnames) {
+        _db->_arena.dealloc_array(_colnames, _num_columns);
+        _colnames = nullptr;
+    }
+    _num_columns = 0;
+}
+
+// the profile needs the run's bindings, so it goes first
+void Statement::_end_run() {
+    _db->_profiler.end(_stmt);
+}
+
+}
@@ -0,0 +1,91 @@
+//  BWStatement.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWSTATEMENT_H
+#define BWSTATEMENT_H
+
+#include <sqlite3.h>
+#include <sqlcpp.h>
+#include "BWBind.h"
+#include "BWRowView.h"
+#include "BWColumns.h"
+#include <cstdio>
+
+namespace bw {
+
+class BWSQL;
+
+// a prepared statement with its own cursor on a BWSQL connection
+// any number of these may be live at once on the same connection
+// the statement comes from (and goes back to) the connection's
+// statement cache, so it must not outlive the connection
+class Statement {
+    BWSQL * _db = nullptr;
+    sqlite3_stmt * _stmt = nullptr;
+    int _num_columns = 0;
+    const char ** _row = nullptr;
+    const char ** _colnames = nullptr;
+
+public:
+    // ctor/dtor
+    Statement() = default;
+    Statement(BWSQL & db, const char * sql);
+    ~Statement();
+
+    // sql methods
+    template<typename... Args> bool bind(Args &&... args);
+    int step();
+    int exec();
+    const char ** fetch_row();
+    RowView fetch_view();
+    RowRange<Statement> rows() &;
+    RowRange<Statement> rows() && = delete;     // the range would outlive the statement
+    int fetch_batch(ColumnBatch & batch, int max_rows = DEFAULT_BATCH_ROWS);
+    const char ** column_names();
+    int num_columns() const;
+    void reset();
+
+    // utilities
+    bool valid() const;
+    explicit operator bool() const;
+    const char * sql() const;
+    sqlite3_stmt * stmt() const;
+    BWSQL * connection() const;
+
+    // rule of five stuff
+    Statement(const Statement &)                = delete;   // no copy
+    Statement & operator = (const Statement &)  = delete;   // no assignment
+    Statement(Statement && other) noexcept;
+    Statement & operator = (Statement && other) noexcept;
+
+private:
+    void _release();
+    void _end_run();
+};
+
+// resets the statement, clears old bindings and binds args in order
+// returns false if the parameter count doesn't match
+template<typename... Args>
+bool Statement::bind(Args &&... args) {
+    if(!_stmt) {
+        return false;
+    }
+    _end_run();
+    sqlite3_reset(_stmt);
+    sqlite3_clear_bindings(_stmt);
+    int param_count = sqlite3_bind_parameter_count(_stmt);
+    if(param_count != (int) sizeof...(Args)) {
+        printf("Statement::bind: %d parameters expected, %d given\n", param_count, (int) sizeof...(Args));
+        return false;
+    }
+    if(bind_params(_stmt, std::forward<Args>(args)...)) {
+        printf("Statement::bind: %s\n", sqlite3_errmsg(sqlite3_db_handle(_stmt)));
+        return false;
+    }
+    return true;
+}
+
+}
+
+#endif // BWSTATEMENT_H
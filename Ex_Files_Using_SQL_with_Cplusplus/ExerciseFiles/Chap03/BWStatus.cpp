@@ -0,0 +1,201 @@
+//  BWStatus.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWStatus.h"
+#include "BWSQL.h"
+
+namespace bw {
+
+// MARK: - status
+
+double BWDbStatus::cache_hit_ratio() const {
+    int64_t total = cache_hit + cache_miss;
+    return total ? (double) cache_hit / (double) total : 0;
+}
+
+// a counter below its last value was reset by a db_status(true)
+// caller – everything since the reset is new
+static int64_t counter_delta(int64_t now, int64_t last) {
+    return now >= last ? now - last : now;
+}
+
+// reset zeroes the cache and lookaside counters
+BWDbStatus sqlite_db_status(sqlite3 * db, bool reset) {
+    BWDbStatus s;
+    if(!db) {
+        return s;
+    }
+    int r = reset ? 1 : 0;
+    int cur = 0;
+    int hi = 0;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED, &cur, &hi, 0);
+    s.cache_used = cur;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED_SHARED, &cur, &hi, 0);
+    s.cache_used_shared = cur;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_HIT, &cur, &hi, r);
+    s.cache_hit = cur;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_MISS, &cur, &hi, r);
+    s.cache_miss = cur;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_WRITE, &cur, &hi, r);
+    s.cache_write = cur;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_SPILL, &cur, &hi, r);
+    s.cache_spill = cur;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_USED, &cur, &hi, r);
+    s.lookaside_used = cur;
+    s.lookaside_used_max = hi;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_HIT, &cur, &hi, r);
+    s.lookaside_hit = hi;           // these report in the highwater
+    sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE, &cur, &hi, r);
+    s.lookaside_miss_size = hi;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, &cur, &hi, r);
+    s.lookaside_miss_full = hi;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_SCHEMA_USED, &cur, &hi, 0);
+    s.schema_used = cur;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_STMT_USED, &cur, &hi, 0);
+    s.stmt_used = cur;
+    return s;
+}
+
+// reset sets the highwater marks back to the current values
+BWMemStatus sqlite_mem_status(bool reset) {
+    BWMemStatus s;
+    int r = reset ? 1 : 0;
+    sqlite3_int64 cur = 0;
+    sqlite3_int64 hi = 0;
+    sqlite3_status64(SQLITE_STATUS_MEMORY_USED, &cur, &hi, r);
+    s.memory_used = cur;
+    s.memory_used_max = hi;
+    sqlite3_status64(SQLITE_STATUS_MALLOC_COUNT, &cur, &hi, r);
+    s.malloc_count = cur;
+    sqlite3_status64(SQLITE_STATUS_MALLOC_SIZE, &cur, &hi, r);
+    s.malloc_size_max = hi;
+    sqlite3_status64(SQLITE_STATUS_PAGECACHE_USED, &cur, &hi, r);
+    s.pagecache_used = cur;
+    sqlite3_status64(SQLITE_STATUS_PAGECACHE_OVERFLOW, &cur, &hi, r);
+    s.pagecache_overflow = cur;
+    sqlite3_status64(SQLITE_STATUS_PAGECACHE_SIZE, &cur, &hi, r);
+    s.pagecache_size_max = hi;
+    return s;
+}
+
+// MARK: - constructors
+
+BWStatusSampler::BWStatusSampler(const char * path, int interval_ms)
+: _interval_ms(interval_ms > 0 ? interval_ms : DEFAULT_STATUS_INTERVAL_MS), _start(clock::now())
+{
+    _file = fopen(path, "a");
+    if(!_file) {
+        printf("BWStatusSampler: cannot open %s\n", path);
+        return;
+    }
+    _worker = std::thread(&BWStatusSampler::_run, this);
+}
+
+BWStatusSampler::~BWStatusSampler() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stop = true;
+    }
+    _wake.notify_one();
+    if(_worker.joinable()) {
+        _worker.join();
+    }
+    if(_file) {
+        std::lock_guard<std::mutex> guard(_lock);
+        _sample();
+        fclose(_file);
+    }
+}
+
+// MARK: - sampler methods
+
+// label defaults to the filename
+void BWStatusSampler::add(BWSQL & db, const char * label) {
+    std::lock_guard<std::mutex> guard(_lock);
+    Entry & e = _entries.emplace_back();
+    e.db = db.db();
+    e.label = label ? label : db.filename();
+    e.last = sqlite_db_status(e.db);
+}
+
+void BWStatusSampler::remove(BWSQL & db) {
+    std::lock_guard<std::mutex> guard(_lock);
+    for(auto it = _entries.begin(); it != _entries.end(); ++it) {
+        if(it->db == db.db()) {
+            _entries.erase(it);
+            return;
+        }
+    }
+}
+
+void BWStatusSampler::sample() {
+    std::lock_guard<std::mutex> guard(_lock);
+    _sample();
+}
+
+// MARK: - utilities
+
+uint64_t BWStatusSampler::samples() {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _samples;
+}
+
+// MARK: - private
+
+void BWStatusSampler::_run() {
+    std::unique_lock<std::mutex> lock(_lock);
+    while(!_stop) {
+        _wake.wait_for(lock, std::chrono::milliseconds(_interval_ms), [this] { return _stop; });
+        if(!_stop) {
+            _sample();
+        }
+    }
+}
+
+// caller holds _lock
+void BWStatusSampler::_sample() {
+    if(!_file) {
+        return;
+    }
+    double t_ms = std::chrono::duration<double, std::milli>(clock::now() - _start).count();
+    BWMemStatus m = sqlite_mem_status();
+    fprintf(_file, "{\"t_ms\":%.1f,\"conn\":\"*\",\"memory_used\":%lld,\"memory_used_max\":%lld,"
+            "\"malloc_count\":%lld,\"malloc_size_max\":%lld,\"pagecache_used\":%lld,"
+            "\"pagecache_overflow\":%lld,\"pagecache_size_max\":%lld}\n",
+            t_ms, (long long) m.memory_used, (long long) m.memory_used_max,
+            (long long) m.malloc_count, (long long) m.malloc_size_max, (long long) m.pagecache_used,
+            (long long) m.pagecache_overflow, (long long) m.pagecache_size_max);
+
+    for(Entry & e : _entries) {
+        BWDbStatus s = sqlite_db_status(e.db);
+        BWDbStatus d;
+        d.cache_hit = counter_delta(s.cache_hit, e.last.cache_hit);
+        d.cache_miss = counter_delta(s.cache_miss, e.last.cache_miss);
+        d.cache_write = counter_delta(s.cache_write, e.last.cache_write);
+        d.cache_spill = counter_delta(s.cache_spill, e.last.cache_spill);
+        d.lookaside_hit = counter_delta(s.lookaside_hit, e.last.lookaside_hit);
+        d.lookaside_miss_size = counter_delta(s.lookaside_miss_size, e.last.lookaside_miss_size);
+        d.lookaside_miss_full = counter_delta(s.lookaside_miss_full, e.last.lookaside_miss_full);
+        e.last = s;
+
+        // the label is a file name or the caller's – quote marks are dropped
+        std::string label = e.label;
+        for(char & c : label) {
+            if(c == '"' || c == '\\') c = '_';
+        }
+        fprintf(_file, "{\"t_ms\":%.1f,\"conn\":\"%s\",\"cache_used\":%lld,\"schema_used\":%lld,"
+                "\"stmt_used\":%lld,\"lookaside_used\":%lld,\"cache_hit\":%lld,\"cache_miss\":%lld,"
+                "\"cache_hit_ratio\":%.4f,\"cache_write\":%lld,\"cache_spill\":%lld,"
+                "\"lookaside_hit\":%lld,\"lookaside_miss_size\":%lld,\"lookaside_miss_full\":%lld}\n",
+                t_ms, label.c_str(), (long long) s.cache_used, (long long) s.schema_used,
+                (long long) s.stmt_used, (long long) s.lookaside_used, (long long) d.cache_hit,
+                (long long) d.cache_miss, d.cache_hit_ratio(), (long long) d.cache_write,
+                (long long) d.cache_spill, (long long) d.lookaside_hit,
+                (long long) d.lookaside_miss_size, (long long) d.lookaside_miss_full);
+    }
+    fflush(_file);
+    ++_samples;
+}
+
+}
@@ -0,0 +1,111 @@
+//  BWStatus.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWSTATUS_H
+#define BWSTATUS_H
+
+#include <sqlite3.h>
+#include <sqlcpp.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bw {
+
+class BWSQL;
+
+#define DEFAULT_STATUS_INTERVAL_MS 1000
+
+// sqlite3_db_status for one connection
+// byte counts are current values, the cache counters
+// count up from the open (or the last reset)
+struct BWDbStatus {
+    int64_t cache_used = 0;             // bytes in the page cache
+    int64_t cache_used_shared = 0;
+    int64_t cache_hit = 0;
+    int64_t cache_miss = 0;
+    int64_t cache_write = 0;
+    int64_t cache_spill = 0;
+    int64_t lookaside_used = 0;         // slots in use
+    int64_t lookaside_used_max = 0;
+    int64_t lookaside_hit = 0;
+    int64_t lookaside_miss_size = 0;
+    int64_t lookaside_miss_full = 0;
+    int64_t schema_used = 0;            // bytes
+    int64_t stmt_used = 0;              // bytes, all prepared statements
+
+    double cache_hit_ratio() const;
+};
+
+// sqlite3_status64, process wide
+struct BWMemStatus {
+    int64_t memory_used = 0;
+    int64_t memory_used_max = 0;
+    int64_t malloc_count = 0;
+    int64_t malloc_size_max = 0;        // largest single request
+    int64_t pagecache_used = 0;         // pages from the pcache buffer
+    int64_t pagecache_overflow = 0;     // bytes that overflowed to malloc
+    int64_t pagecache_size_max = 0;
+};
+
+BWDbStatus sqlite_db_status(sqlite3 * db, bool reset = false);
+BWMemStatus sqlite_mem_status(bool reset = false);
+
+// samples registered connections and global memory every interval
+// and appends one JSON line per connection per sample, with gauges
+// as current values and the cache counters as deltas since the last sample
+// the sampler reads the counters without resetting them, so it
+// doesn't disturb db_status() callers; a db_status(true) between
+// samples is seen as a counter going down, and the delta is the new value
+// a connection is read from the sampler thread – don't register one
+// opened with SQLITE_OPEN_NOMUTEX, and remove it before it closes
+class BWStatusSampler {
+    using clock = std::chrono::steady_clock;
+
+    struct Entry {
+        sqlite3 * db = nullptr;
+        std::string label;
+        BWDbStatus last;
+    };
+
+    FILE * _file = nullptr;
+    int _interval_ms;
+    std::vector<Entry> _entries;
+    clock::time_point _start;
+    uint64_t _samples = 0;
+    bool _stop = false;
+    std::mutex _lock;
+    std::condition_variable _wake;
+    std::thread _worker;
+
+public:
+    // ctor/dtor
+    BWStatusSampler(const char * path, int interval_ms = DEFAULT_STATUS_INTERVAL_MS);
+    ~BWStatusSampler();     // writes one last sample
+
+    // sampler methods
+    void add(BWSQL & db, const char * label = nullptr);
+    void remove(BWSQL & db);
+    void sample();          // now, as well as on the timer
+
+    // utilities
+    uint64_t samples();
+
+    // rule of five stuff
+    BWStatusSampler(const BWStatusSampler &)                = delete;   // no copy
+    BWStatusSampler & operator = (const BWStatusSampler &)  = delete;   // no assignment
+
+private:
+    void _run();
+    void _sample();
+};
+
+}
+
+#endif // BWSTATUS_H
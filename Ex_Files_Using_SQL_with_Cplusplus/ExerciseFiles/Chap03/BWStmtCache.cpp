@@ -0,0 +1,181 @@
+//  BWStmtCache.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWStmtCache.h"
+#include "BWTrace.h"
+
+namespace bw {
+
+// MARK: - constructors
+
+BWStmtCache::BWStmtCache(int capacity) {
+    resize(capacity);
+}
+
+BWStmtCache::~BWStmtCache() {
+    clear();
+    delete [] _slots;
+}
+
+// MARK: - cache methods
+
+// returns a prepared statement for sql, from the cache if possible
+// the statement is borrowed until it's passed back to release()
+sqlite3_stmt * BWStmtCache::acquire(sqlite3 * db, const char * sql, int * rc) {
+    if(rc) *rc = SQLITE_OK;
+    uint32_t hash = _hash(sql);
+
+    // look for an idle statement with the same sql
+    for(int index = 0; index < _capacity; ++index) {
+        Slot & slot = _slots[index];
+        if(slot.stmt && !slot.in_use && slot.hash == hash && slot.sql == sql) {
+            slot.in_use = true;
+            slot.last_used = ++_tick;
+            ++_stats.hits;
+            return slot.stmt;
+        }
+    }
+
+    ++_stats.misses;
+    sqlite3_stmt * stmt = nullptr;
+    auto start = BWTracer::now();
+    int prc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if(_tracer) {
+        _tracer->span(db, "prepare", start, BWTracer::now(), sql);
+    }
+    if(rc) *rc = prc;
+    if(prc || !stmt) {
+        return nullptr;
+    }
+
+    // find an empty slot, or else the least recently used idle slot
+    Slot * victim = nullptr;
+    for(int index = 0; index < _capacity; ++index) {
+        Slot & slot = _slots[index];
+        if(!slot.stmt) {
+            victim = &slot;
+            break;
+        }
+        if(!slot.in_use && (!victim || slot.last_used < victim->last_used)) {
+            victim = &slot;
+        }
+    }
+
+    // everything is borrowed – hand back an uncached statement
+    if(!victim) {
+        return stmt;
+    }
+
+    if(victim->stmt) {
+        _finalize(victim->stmt);
+        ++_stats.evictions;
+        --_stats.size;
+    }
+    victim->stmt = stmt;
+    victim->sql = sql;
+    victim->hash = hash;
+    victim->last_used = ++_tick;
+    victim->in_use = true;
+    ++_stats.size;
+    return stmt;
+}
+
+// return a borrowed statement to the cache
+// statements that are not in the cache are finalized
+void BWStmtCache::release(sqlite3_stmt * stmt) {
+    if(!stmt) {
+        return;
+    }
+    Slot * slot = _find(stmt);
+    if(!slot) {
+        _finalize(stmt);
+        return;
+    }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    slot->in_use = false;
+}
+
+// finalize all idle statements
+// must be called before closing the database
+// borrowed statements are dropped from the cache and finalized on release
+void BWStmtCache::clear() {
+    for(int index = 0; index < _capacity; ++index) {
+        Slot & slot = _slots[index];
+        if(slot.stmt && !slot.in_use) {
+            _finalize(slot.stmt);
+        }
+        slot = Slot();
+    }
+    _stats.size = 0;
+}
+
+// idle statements are finalized
+// borrowed statements are dropped from the cache and finalized on release
+void BWStmtCache::resize(int capacity) {
+    for(int index = 0; index < _capacity; ++index) {
+        Slot & slot = _slots[index];
+        if(slot.stmt && !slot.in_use) {
+            _finalize(slot.stmt);
+        }
+    }
+    delete [] _slots;
+    _slots = nullptr;
+    _capacity = capacity > 0 ? capacity : 0;
+    if(_capacity) {
+        _slots = new Slot[_capacity];
+    }
+    _stats.size = 0;
+    _stats.capacity = _capacity;
+}
+
+BWStmtCacheStats BWStmtCache::stats() const {
+    return _stats;
+}
+
+void BWStmtCache::reset_stats() {
+    _stats.hits = 0;
+    _stats.misses = 0;
+    _stats.evictions = 0;
+}
+
+// prepare and finalize spans, nullptr turns them off
+void BWStmtCache::tracer(BWTracer * tracer) {
+    _tracer = tracer;
+}
+
+// MARK: - private
+
+// FNV-1a, used to skip most of the string compares
+uint32_t BWStmtCache::_hash(const char * sql) {
+    uint32_t hash = 2166136261u;
+    for(; *sql; ++sql) {
+        hash ^= (unsigned char) *sql;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+BWStmtCache::Slot * BWStmtCache::_find(sqlite3_stmt * stmt) {
+    for(int index = 0; index < _capacity; ++index) {
+        if(_slots[index].stmt == stmt) {
+            return &_slots[index];
+        }
+    }
+    return nullptr;
+}
+
+void BWStmtCache::_finalize(sqlite3_stmt * stmt) {
+    if(!_tracer) {
+        sqlite3_finalize(stmt);
+        return;
+    }
+    sqlite3 * db = sqlite3_db_handle(stmt);
+    std::string sql = sqlite3_sql(stmt);
+    auto start = BWTracer::now();
+    sqlite3_finalize(stmt);
+    _tracer->span(db, "finalize", start, BWTracer::now(), sql.c_str());
+}
+
+}
@@ -0,0 +1,69 @@
+//  BWStmtCache.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWSTMTCACHE_H
+#define BWSTMTCACHE_H
+
+#include <sqlite3.h>
+#include <sqlcpp.h>
+#include <cstdint>
+#include <string>
+
+namespace bw {
+
+class BWTracer;
+
+#define DEFAULT_STMT_CACHE_SIZE 32
+
+struct BWStmtCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    int size = 0;           // statements currently held
+    int capacity = 0;
+};
+
+// bounded LRU cache of prepared statements, keyed by SQL text
+// a statement is either borrowed (in use) or idle in the cache
+// idle statements are always reset with bindings cleared
+class BWStmtCache {
+    struct Slot {
+        sqlite3_stmt * stmt = nullptr;
+        std::string sql;        // the caller's text – sqlite3_sql() stops at the first statement
+        uint32_t hash = 0;
+        uint64_t last_used = 0;
+        bool in_use = false;
+    };
+
+    Slot * _slots = nullptr;
+    int _capacity = 0;
+    uint64_t _tick = 0;
+    BWStmtCacheStats _stats;
+    BWTracer * _tracer = nullptr;
+
+public:
+    BWStmtCache(int capacity = DEFAULT_STMT_CACHE_SIZE);
+    ~BWStmtCache();
+
+    sqlite3_stmt * acquire(sqlite3 * db, const char * sql, int * rc = nullptr);
+    void release(sqlite3_stmt * stmt);
+    void clear();
+    void resize(int capacity);
+    BWStmtCacheStats stats() const;
+    void reset_stats();
+    void tracer(BWTracer * tracer);
+
+    // rule of five stuff
+    BWStmtCache(const BWStmtCache &)                = delete;   // no copy
+    BWStmtCache & operator = (const BWStmtCache &)  = delete;   // no assignment
+
+private:
+    static uint32_t _hash(const char * sql);
+    void _finalize(sqlite3_stmt * stmt);
+    Slot * _find(sqlite3_stmt * stmt);
+};
+
+}
+
+#endif // BWSTMTCACHE_H
@@ -0,0 +1,180 @@
+//  BWStmtStats.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWStmtStats.h"
+#include "BWSlowLog.h"
+#include <algorithm>
+
+namespace bw {
+
+// MARK: - profiler methods
+
+// sqlite3_step, timed
+int BWStmtProfiler::step(sqlite3_stmt * stmt) {
+    if(!_enabled.load(std::memory_order_relaxed) || !stmt) {
+        return sqlite3_step(stmt);
+    }
+    begin(stmt);
+    clock::time_point start = clock::now();
+    int rc = sqlite3_step(stmt);
+    uint64_t ns = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+    add(stmt, ns, rc == SQLITE_ROW ? 1 : 0);
+    if(rc != SQLITE_ROW) {
+        end(stmt);      // done or failed, bindings are still in place
+    }
+    return rc;
+}
+
+// call before stepping stmt some other way
+// a statement that isn't mid-run is starting a new one,
+// so the last run is flushed before its counters move
+void BWStmtProfiler::begin(sqlite3_stmt * stmt) {
+    if(_enabled.load(std::memory_order_relaxed) && stmt && !sqlite3_stmt_busy(stmt)) {
+        end(stmt);
+    }
+}
+
+// time and rows from stepping stmt some other way
+void BWStmtProfiler::add(sqlite3_stmt * stmt, uint64_t ns, uint64_t rows) {
+    if(!_enabled.load(std::memory_order_relaxed) || !stmt) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(_lock);
+    Run & run = _runs[stmt];
+    run.ns += ns;
+    run.rows += rows;
+}
+
+// flush the current run of stmt into the totals
+// call before the statement is reset, rebound or released
+// the slow log is written after the lock is let go
+void BWStmtProfiler::end(sqlite3_stmt * stmt) {
+    if(!_enabled.load(std::memory_order_relaxed) || !stmt) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = _runs.find(stmt);
+    if(it == _runs.end()) {
+        return;
+    }
+
+    // the reset flag zeroes the counters for the next run
+    BWStmtStats run;
+    run.execs = 1;
+    run.rows = it->second.rows;
+    run.total_ms = run.max_ms = (double) it->second.ns / 1e6;
+    run.fullscan_steps = (uint64_t) sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+    run.sorts = (uint64_t) sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, 1);
+    run.autoindexes = (uint64_t) sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+    run.vm_steps = (uint64_t) sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1);
+    run.reprepares = (uint64_t) sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_REPREPARE, 1);
+    run.runs = (uint64_t) sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_RUN, 1);
+    run.memused = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_MEMUSED, 0);
+    uint64_t ns = it->second.ns;
+    _runs.erase(it);
+
+    const char * sql = sqlite3_sql(stmt);
+    auto entry_it = _entries.find(sql);
+    if(entry_it == _entries.end()) {
+        entry_it = _entries.emplace(sql, Entry()).first;
+        entry_it->second.stats.sql = sql;
+    }
+    Entry & e = entry_it->second;
+    BWStmtStats & s = e.stats;
+    ++s.execs;
+    s.rows += run.rows;
+    e.total_ns += ns;
+    if(ns > e.max_ns) e.max_ns = ns;
+
+    int bucket = 0;
+    for(uint64_t us = ns / 1000; us > 1 && bucket < STMT_STATS_BUCKETS - 1; us >>= 1) {
+        ++bucket;
+    }
+    ++e.buckets[bucket];
+
+    s.fullscan_steps += run.fullscan_steps;
+    s.sorts += run.sorts;
+    s.autoindexes += run.autoindexes;
+    s.vm_steps += run.vm_steps;
+    s.reprepares += run.reprepares;
+    s.runs += run.runs;
+    if(run.memused > s.memused) s.memused = run.memused;
+    lock.unlock();
+
+    BWSlowLog * log = _slow_log.load(std::memory_order_acquire);
+    if(log && log->is_slow(run.total_ms)) {
+        log->record(stmt, run);
+    }
+}
+
+// one entry per SQL text, most total time first
+std::vector<BWStmtStats> BWStmtProfiler::snapshot() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    std::vector<BWStmtStats> out;
+    out.reserve(_entries.size());
+    for(const auto & [sql, e] : _entries) {
+        BWStmtStats s = e.stats;
+        s.total_ms = (double) e.total_ns / 1e6;
+        s.max_ms = (double) e.max_ns / 1e6;
+
+        // walk the buckets to each percentile
+        const double pcts[] = { 0.50, 0.95, 0.99 };
+        double * outs[] = { &s.p50_ms, &s.p95_ms, &s.p99_ms };
+        for(int p = 0; p < 3; ++p) {
+            uint64_t target = (uint64_t) ((double) s.execs * pcts[p]);
+            if(target < 1) target = 1;
+            uint64_t seen = 0;
+            for(int bucket = 0; bucket < STMT_STATS_BUCKETS; ++bucket) {
+                seen += e.buckets[bucket];
+                if(seen >= target) {
+                    *outs[p] = std::min(_bucket_ms(bucket), s.max_ms);
+                    break;
+                }
+            }
+        }
+        out.push_back(std::move(s));
+    }
+    std::sort(out.begin(), out.end(), [](const BWStmtStats & a, const BWStmtStats & b) {
+        return a.total_ms > b.total_ms;
+    });
+    return out;
+}
+
+// runs in progress are dropped too – their counters
+// will be folded into their next run
+void BWStmtProfiler::reset() {
+    std::lock_guard<std::mutex> guard(_lock);
+    _runs.clear();
+    _entries.clear();
+}
+
+void BWStmtProfiler::enable(bool on) {
+    std::lock_guard<std::mutex> guard(_lock);
+    if(!on) {
+        _runs.clear();
+    }
+    _enabled.store(on, std::memory_order_relaxed);
+}
+
+bool BWStmtProfiler::enabled() const {
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+// not owned, nullptr turns it off
+// a log needs the timings, so it turns profiling on
+void BWStmtProfiler::slow_log(BWSlowLog * log) {
+    _slow_log.store(log, std::memory_order_release);
+    if(log) {
+        enable(true);
+    }
+}
+
+// MARK: - private
+
+// upper bound of a bucket
+double BWStmtProfiler::_bucket_ms(int bucket) {
+    return (double) (2ull << bucket) / 1000.0;
+}
+
+}
@@ -0,0 +1,94 @@
+//  BWStmtStats.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWSTMTSTATS_H
+#define BWSTMTSTATS_H
+
+#include <sqlite3.h>
+#include <sqlcpp.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bw {
+
+class BWSlowLog;
+
+#define STMT_STATS_BUCKETS 32   // log2 microseconds, 1us to over an hour
+
+// everything known about one SQL text
+// an execution runs from the first step to the reset
+struct BWStmtStats {
+    std::string sql;
+    uint64_t execs = 0;
+    uint64_t rows = 0;              // SQLITE_ROW results
+    double total_ms = 0;            // time inside sqlite3_step
+    double max_ms = 0;
+    double p50_ms = 0;              // percentiles are bucket bounds,
+    double p95_ms = 0;              // good to within 2x
+    double p99_ms = 0;
+    // sqlite3_stmt_status, summed over executions
+    uint64_t fullscan_steps = 0;    // table scan steps – a missing index
+    uint64_t sorts = 0;
+    uint64_t autoindexes = 0;       // indexes built on the fly
+    uint64_t vm_steps = 0;
+    uint64_t reprepares = 0;        // schema changes
+    uint64_t runs = 0;
+    int memused = 0;                // bytes, largest seen
+};
+
+// per-connection statement profiler
+// steps go through step(), which times them and counts rows
+// the run is flushed into the totals for its SQL text when a step
+// finishes it, when the statement starts a new run, or by end()
+// a run over the slow log's threshold is written to the log
+// off until enable(true) or a slow log turns it on – a step then
+// costs two clock reads and a lookup
+// a statement may be stepped on another thread (PrefetchCursor), so
+// the runs and totals are under a lock of their own
+class BWStmtProfiler {
+    using clock = std::chrono::steady_clock;
+
+    struct Run {
+        uint64_t ns = 0;
+        uint64_t rows = 0;
+    };
+
+    struct Entry {
+        BWStmtStats stats;
+        uint64_t total_ns = 0;
+        uint64_t max_ns = 0;
+        uint64_t buckets[STMT_STATS_BUCKETS] = {};
+    };
+
+    std::unordered_map<sqlite3_stmt *, Run> _runs;
+    std::map<std::string, Entry, std::less<>> _entries;
+    std::atomic<bool> _enabled { false };
+    std::atomic<BWSlowLog *> _slow_log { nullptr };
+    mutable std::mutex _lock;
+
+public:
+    int step(sqlite3_stmt * stmt);
+    void begin(sqlite3_stmt * stmt);
+    void add(sqlite3_stmt * stmt, uint64_t ns, uint64_t rows);
+    void end(sqlite3_stmt * stmt);
+    std::vector<BWStmtStats> snapshot() const;
+    void reset();
+    void enable(bool on);
+    bool enabled() const;
+    void slow_log(BWSlowLog * log);
+
+private:
+    static double _bucket_ms(int bucket);
+};
+
+}
+
+#endif // BWSTMTSTATS_H
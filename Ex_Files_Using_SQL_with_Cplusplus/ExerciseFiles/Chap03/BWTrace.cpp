@@ -0,0 +1,211 @@
+//  BWTrace.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWTrace.h"
+
+namespace bw {
+
+static thread_local const char * trace_op = nullptr;
+
+// MARK: - operation tags
+
+BWTraceScope::BWTraceScope(const char * op)
+: _previous(trace_op)
+{
+    if(!trace_op) {
+        trace_op = op;
+    }
+}
+
+BWTraceScope::~BWTraceScope() {
+    trace_op = _previous;
+}
+
+const char * BWTraceScope::current() {
+    return trace_op;
+}
+
+// MARK: - constructors
+
+BWTracer::BWTracer(const char * path)
+: _start(clock::now())
+{
+    _file = fopen(path, "w");
+    if(!_file) {
+        printf("BWTracer: cannot open %s\n", path);
+        return;
+    }
+    fputs("[", _file);
+}
+
+BWTracer::~BWTracer() {
+    if(_file) {
+        fputs("\n]\n", _file);
+        fclose(_file);
+    }
+}
+
+// MARK: - trace methods
+
+// label names the connection's track, the filename if nullptr
+// returns the handle for detach(), nullptr on failure
+BWTracer::Conn * BWTracer::attach(sqlite3 * db, unsigned mask, const char * label) {
+    if(!db || !_file) {
+        return nullptr;
+    }
+    Conn * conn = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        conn = &_conns.emplace_back();
+        conn->tracer = this;
+        conn->db = db;
+        conn->pid = _next_pid++;
+        if(!label) {
+            label = sqlite3_db_filename(db, "main");
+        }
+        fprintf(_file, "%s\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":",
+                _events ? "," : "", conn->pid);
+        _json_string((label && *label) ? label : "memory");
+        fputs("}}", _file);
+        ++_events;
+    }
+    if(sqlite3_trace_v2(db, mask, &BWTracer::_callback, conn) != SQLITE_OK) {
+        detach(conn);
+        return nullptr;
+    }
+    return conn;
+}
+
+// forgets the connection – call after sqlite3_close(), or after
+// sqlite3_trace_v2(db, 0, ...), when no callback can be in flight
+// by handle, not by sqlite3 *, since a new connection may already
+// have the closed one's address
+void BWTracer::detach(Conn * conn) {
+    if(!conn) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(_lock);
+    _conns.remove_if([conn](const Conn & c) { return &c == conn; });
+}
+
+// a complete event for work sqlite doesn't trace itself
+void BWTracer::span(sqlite3 * db, const char * name, clock::time_point start, clock::time_point end,
+                    const char * sql) {
+    if(!_file) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(_lock);
+    _write(name, 'X', _us(start), _us(end) - _us(start), _pid(db), sql);
+}
+
+// MARK: - utilities
+
+bool BWTracer::is_open() const {
+    return _file != nullptr;
+}
+
+uint64_t BWTracer::events() {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _events;
+}
+
+BWTracer::clock::time_point BWTracer::now() {
+    return clock::now();
+}
+
+// MARK: - private
+
+int BWTracer::_callback(unsigned type, void * ctx, void * p, void * x) {
+    Conn * conn = (Conn *) ctx;
+    BWTracer * tracer = conn->tracer;
+    clock::time_point now = clock::now();
+    std::lock_guard<std::mutex> guard(tracer->_lock);
+    double ts = tracer->_us(now);
+    switch(type) {
+        case SQLITE_TRACE_STMT:
+            tracer->_write("stmt", 'i', ts, 0, conn->pid, sqlite3_sql((sqlite3_stmt *) p));
+            break;
+        case SQLITE_TRACE_PROFILE: {
+            // x is the run time in ns, and the run just ended
+            double dur = (double) *(sqlite3_int64 *) x / 1000.0;
+            tracer->_write("step", 'X', ts - dur, dur, conn->pid, sqlite3_sql((sqlite3_stmt *) p));
+            break;
+        }
+        case SQLITE_TRACE_ROW:
+            tracer->_write("row", 'i', ts, 0, conn->pid, nullptr);
+            break;
+        case SQLITE_TRACE_CLOSE:
+            tracer->_write("close", 'i', ts, 0, conn->pid, nullptr);
+            break;
+    }
+    return 0;
+}
+
+// caller holds _lock
+int BWTracer::_pid(sqlite3 * db) {
+    for(const Conn & conn : _conns) {
+        if(conn.db == db) {
+            return conn.pid;
+        }
+    }
+    return 0;
+}
+
+// caller holds _lock
+void BWTracer::_write(const char * name, char phase, double ts_us, double dur_us, int pid,
+                      const char * sql) {
+    // the separator goes first, so the array never ends with a comma
+    fprintf(_file, "%s\n{\"name\":\"%s\",\"cat\":\"sql\",\"ph\":\"%c\",\"ts\":%.3f,",
+            _events ? "," : "", name, phase, ts_us);
+    if(phase == 'X') {
+        fprintf(_file, "\"dur\":%.3f,", dur_us);
+    } else if(phase == 'i') {
+        fputs("\"s\":\"t\",", _file);
+    }
+    fprintf(_file, "\"pid\":%d,\"tid\":%d,\"args\":{", pid, _tid());
+    const char * op = BWTraceScope::current();
+    if(op) {
+        fprintf(_file, "\"op\":\"%s\"%s", op, sql ? "," : "");
+    }
+    if(sql) {
+        fputs("\"sql\":", _file);
+        _json_string(sql);
+    }
+    fputs("}}", _file);
+    ++_events;
+}
+
+// quoted, with JSON escapes
+void BWTracer::_json_string(const char * str) {
+    fputc('"', _file);
+    for(const char * c = str; *c; ++c) {
+        switch(*c) {
+            case '"': fputs("\\\"", _file); break;
+            case '\\': fputs("\\\\", _file); break;
+            case '\n': fputs("\\n", _file); break;
+            case '\r': fputs("\\r", _file); break;
+            case '\t': fputs("\\t", _file); break;
+            default:
+                if((unsigned char) *c < 0x20) {
+                    fprintf(_file, "\\u%04x", (unsigned char) *c);
+                } else {
+                    fputc(*c, _file);
+                }
+        }
+    }
+    fputc('"', _file);
+}
+
+double BWTracer::_us(clock::time_point t) const {
+    return std::chrono::duration<double, std::micro>(t - _start).count();
+}
+
+// small numbers read better than native thread ids
+int BWTracer::_tid() {
+    static std::atomic<int> next_tid { 1 };
+    static thread_local int tid = next_tid++;
+    return tid;
+}
+
+}
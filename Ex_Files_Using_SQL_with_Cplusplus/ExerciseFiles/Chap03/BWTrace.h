@@ -0,0 +1,103 @@
+//  BWTrace.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWTRACE_H
+#define BWTRACE_H
+
+#include <sqlite3.h>
+#include <sqlcpp.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <mutex>
+#include <string>
+
+namespace bw {
+
+#define BW_TRACE_ALL (SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE | SQLITE_TRACE_ROW | SQLITE_TRACE_CLOSE)
+
+// MARK: - operation tags
+
+// names the operation the current thread is in, e.g. "insert"
+// events recorded while the scope is alive carry the tag
+// scopes nest, the outermost wins – find_row() calling find_rows()
+// is still find_row
+class BWTraceScope {
+    const char * _previous;
+
+public:
+    explicit BWTraceScope(const char * op);
+    ~BWTraceScope();
+    static const char * current();      // nullptr outside any scope
+
+    BWTraceScope(const BWTraceScope &)                = delete;
+    BWTraceScope & operator = (const BWTraceScope &)  = delete;
+};
+
+#define BW_TRACE_OP(op) bw::BWTraceScope _bw_trace_scope(op)
+
+// MARK: - tracer
+
+// Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev)
+// sqlite3_trace_v2 gives a span for each statement run (PROFILE),
+// plus instants for statement start, each row and close
+// the statement cache adds prepare and finalize spans
+// each connection is a pid, each thread a tid, and every event
+// carries the thread's BWTraceScope tag
+// one tracer may be shared by any number of connections,
+// which must be closed or detached before the tracer is destroyed
+class BWTracer {
+    using clock = std::chrono::steady_clock;
+
+public:
+    struct Conn;                    // one attached connection, from attach()
+
+private:
+    FILE * _file = nullptr;
+    clock::time_point _start;
+    std::list<Conn> _conns;         // stable addresses for the callbacks
+    int _next_pid = 1;
+    uint64_t _events = 0;
+    std::mutex _lock;
+
+public:
+    // ctor/dtor
+    BWTracer(const char * path);
+    ~BWTracer();                    // closes the JSON array
+
+    // trace methods
+    Conn * attach(sqlite3 * db, unsigned mask = BW_TRACE_ALL, const char * label = nullptr);
+    void detach(Conn * conn);
+    void span(sqlite3 * db, const char * name, clock::time_point start, clock::time_point end,
+              const char * sql = nullptr);
+
+    // utilities
+    bool is_open() const;
+    uint64_t events();
+    static clock::time_point now();
+
+    // rule of five stuff
+    BWTracer(const BWTracer &)                = delete;   // no copy
+    BWTracer & operator = (const BWTracer &)  = delete;   // no assignment
+
+private:
+    static int _callback(unsigned type, void * ctx, void * p, void * x);
+    int _pid(sqlite3 * db);
+    void _write(const char * name, char phase, double ts_us, double dur_us, int pid,
+                const char * sql);
+    void _json_string(const char * str);
+    double _us(clock::time_point t) const;
+    static int _tid();
+};
+
+struct BWTracer::Conn {
+    BWTracer * tracer = nullptr;
+    sqlite3 * db = nullptr;
+    int pid = 0;
+};
+
+}
+
+#endif // BWTRACE_H
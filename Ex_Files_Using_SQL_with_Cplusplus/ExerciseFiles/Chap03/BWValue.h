@@ -0,0 +1,117 @@
+//  BWValue.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWVALUE_H
+#define BWVALUE_H
+
+#include <sqlite3.h>
+#include "BWBind.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace bw {
+
+// one owned SQL value – a copy that outlives its statement
+// text and blob bytes share one string, so assigning over
+// an old value reuses its storage
+// a blob with no data is a zeroblob of i bytes, as bind_param(blob) has it
+struct Value {
+    int type = SQLITE_NULL;     // SQLITE_INTEGER, _FLOAT, _TEXT, _BLOB or _NULL
+    int64_t i = 0;
+    double d = 0;
+    std::string bytes;
+
+    Value() = default;
+    template<typename T> Value(T && v) { set(std::forward<T>(v)); }
+
+    void set(std::nullptr_t) { type = SQLITE_NULL; }
+    void set(const char * v) {
+        if(!v) { type = SQLITE_NULL; return; }
+        type = SQLITE_TEXT;
+        bytes.assign(v);
+    }
+    void set(std::string_view v) { type = SQLITE_TEXT; bytes.assign(v.data(), v.size()); }
+    void set(const std::string & v) { type = SQLITE_TEXT; bytes.assign(v); }
+    void set(std::string && v) { type = SQLITE_TEXT; bytes = std::move(v); }
+    void set(blob v) {
+        type = SQLITE_BLOB;
+        i = v.data ? 0 : v.size;
+        bytes.assign((const char *) v.data, v.data ? (size_t) v.size : 0);
+    }
+    void set(const Value & v) { *this = v; }
+    void set(Value & v) { *this = v; }
+    void set(Value && v) { *this = std::move(v); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    void set(T v) { type = SQLITE_INTEGER; i = (int64_t) v; }
+    template<typename T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+    void set(T v) { type = SQLITE_FLOAT; d = (double) v; }
+
+    // copy column col of the current row
+    void set_column(sqlite3_stmt * stmt, int col) {
+        type = sqlite3_column_type(stmt, col);
+        switch(type) {
+            case SQLITE_INTEGER:
+                i = sqlite3_column_int64(stmt, col);
+                break;
+            case SQLITE_FLOAT:
+                d = sqlite3_column_double(stmt, col);
+                break;
+            case SQLITE_TEXT:
+                bytes.assign((const char *) sqlite3_column_text(stmt, col),
+                             (size_t) sqlite3_column_bytes(stmt, col));
+                break;
+            case SQLITE_BLOB: {
+                const char * data = (const char *) sqlite3_column_blob(stmt, col);
+                i = 0;
+                bytes.assign(data ? data : "", (size_t) sqlite3_column_bytes(stmt, col));
+                break;
+            }
+            default:
+                type = SQLITE_NULL;
+                break;
+        }
+    }
+
+    bool is_null() const { return type == SQLITE_NULL; }
+    int64_t as_int64() const {
+        return type == SQLITE_INTEGER ? i : type == SQLITE_FLOAT ? (int64_t) d : 0;
+    }
+    double as_double() const {
+        return type == SQLITE_FLOAT ? d : type == SQLITE_INTEGER ? (double) i : 0.0;
+    }
+    std::string_view as_text() const { return std::string_view(bytes); }
+    blob as_blob() const {
+        if(type == SQLITE_BLOB && i) {
+            return blob{ nullptr, (int) i };
+        }
+        return blob{ bytes.data(), (int) bytes.size() };
+    }
+};
+
+// the value owns its bytes, so these bind SQLITE_STATIC
+// by default – keep the Value alive until the statement is reset
+inline int bind_param(sqlite3_stmt * stmt, int index, const Value & value,
+                      sqlite3_destructor_type dtor = SQLITE_STATIC) {
+    switch(value.type) {
+        case SQLITE_INTEGER:
+            return sqlite3_bind_int64(stmt, index, value.i);
+        case SQLITE_FLOAT:
+            return sqlite3_bind_double(stmt, index, value.d);
+        case SQLITE_TEXT:
+            return sqlite3_bind_text(stmt, index, value.bytes.data(), (int) value.bytes.size(), dtor);
+        case SQLITE_BLOB:
+            if(value.i) {
+                return sqlite3_bind_zeroblob(stmt, index, (int) value.i);
+            }
+            return sqlite3_bind_blob(stmt, index, value.bytes.data(), (int) value.bytes.size(), dtor);
+        default:
+            return sqlite3_bind_null(stmt, index);
+    }
+}
+
+}
+
+#endif // BWVALUE_H
@@ -0,0 +1,449 @@
+//  BWVfs.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#include "BWVfs.h"
+#include "BWTrace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define BW_VFS_ADVISE 1
+#endif
+
+namespace bw {
+
+// MARK: - counters
+
+// shared by every handle on the same path, so the totals
+// survive the connection that made them
+struct IoCounters {
+    std::atomic<int64_t> reads { 0 };
+    std::atomic<int64_t> bytes_read { 0 };
+    std::atomic<int64_t> writes { 0 };
+    std::atomic<int64_t> bytes_written { 0 };
+    std::atomic<int64_t> syncs { 0 };
+    std::atomic<int64_t> seq_reads { 0 };
+    std::atomic<int64_t> readaheads { 0 };
+
+    BWIoStats load() const {
+        BWIoStats s;
+        s.reads = reads.load(std::memory_order_relaxed);
+        s.bytes_read = bytes_read.load(std::memory_order_relaxed);
+        s.writes = writes.load(std::memory_order_relaxed);
+        s.bytes_written = bytes_written.load(std::memory_order_relaxed);
+        s.syncs = syncs.load(std::memory_order_relaxed);
+        s.seq_reads = seq_reads.load(std::memory_order_relaxed);
+        s.readaheads = readaheads.load(std::memory_order_relaxed);
+        return s;
+    }
+    void clear() {
+        reads = 0;
+        bytes_read = 0;
+        writes = 0;
+        bytes_written = 0;
+        syncs = 0;
+        seq_reads = 0;
+        readaheads = 0;
+    }
+};
+
+static inline void bump(std::atomic<int64_t> & counter, int64_t n = 1) {
+    counter.fetch_add(n, std::memory_order_relaxed);
+}
+
+BWIoStats & BWIoStats::operator += (const BWIoStats & rhs) {
+    reads += rhs.reads;
+    bytes_read += rhs.bytes_read;
+    writes += rhs.writes;
+    bytes_written += rhs.bytes_written;
+    syncs += rhs.syncs;
+    seq_reads += rhs.seq_reads;
+    readaheads += rhs.readaheads;
+    return *this;
+}
+
+// files are looked up at open, under the lock, and never removed
+static std::mutex files_lock;
+static std::map<std::string, std::unique_ptr<IoCounters>> files;
+
+static IoCounters * file_counters(const char * path) {
+    std::lock_guard<std::mutex> guard(files_lock);
+    std::unique_ptr<IoCounters> & c = files[path ? path : "(temp)"];
+    if(!c) {
+        c = std::make_unique<IoCounters>();
+    }
+    return c.get();
+}
+
+// op tags are string literals, so a slot is found by pointer
+// and claimed with a compare-exchange – no lock on the I/O path
+// past the table size everything lands in the last slot
+constexpr int max_op_slots = 64;
+static const char * const no_op = "(none)";
+
+struct OpSlot {
+    std::atomic<const char *> op { nullptr };
+    IoCounters io;
+};
+static OpSlot op_slots[max_op_slots];
+
+static IoCounters & op_counters() {
+    const char * op = BWTraceScope::current();
+    if(!op) op = no_op;
+    for(int i = 0; i < max_op_slots - 1; ++i) {
+        const char * current = op_slots[i].op.load(std::memory_order_acquire);
+        if(current == op) {
+            return op_slots[i].io;
+        }
+        if(!current) {
+            if(op_slots[i].op.compare_exchange_strong(current, op, std::memory_order_acq_rel)
+               || current == op) {
+                return op_slots[i].io;
+            }
+        }
+    }
+    op_slots[max_op_slots - 1].op.store("(other)", std::memory_order_relaxed);
+    return op_slots[max_op_slots - 1].io;
+}
+
+static std::atomic<int64_t> readahead_window { DEFAULT_VFS_READAHEAD };
+static std::atomic<int> seq_threshold { DEFAULT_VFS_SEQ_THRESHOLD };
+
+// MARK: - file
+
+// the real file follows this struct, in the szOsFile bytes sqlite allocates
+// sqlite serializes calls on one handle, so the read state needs no lock
+struct BWVfsFile {
+    sqlite3_file base;
+    sqlite3_file * real;
+    IoCounters * counters;
+    const char * path;          // sqlite keeps it alive until close
+    bool main_db;
+    int side_fd;
+    sqlite3_int64 last_end;
+    sqlite3_int64 advised_end;
+    int seq_run;
+};
+
+static sqlite3_file * real_file(sqlite3_file * f) {
+    return ((BWVfsFile *) f)->real;
+}
+
+// a read that starts at, or just past, where the last one ended
+// continues the run – b-tree leaves of a loaded table are close to
+// contiguous but not exactly
+static void track_read(BWVfsFile * f, sqlite3_int64 offset, int amount) {
+    if(offset >= f->last_end && offset - f->last_end <= 2 * (sqlite3_int64) amount) {
+        ++f->seq_run;
+    } else {
+        f->seq_run = 0;
+    }
+    f->last_end = offset + amount;
+    if(f->seq_run < seq_threshold.load(std::memory_order_relaxed)) {
+        return;
+    }
+    bump(f->counters->seq_reads);
+    int64_t window = readahead_window.load(std::memory_order_relaxed);
+    if(!f->main_db || window <= 0 || f->last_end + window / 2 < f->advised_end) {
+        return;
+    }
+#ifdef BW_VFS_ADVISE
+    if(f->side_fd < 0) {
+        f->side_fd = open(f->path, O_RDONLY | O_CLOEXEC);
+        if(f->side_fd < 0) {
+            f->main_db = false;     // no second try
+            return;
+        }
+    }
+    sqlite3_int64 start = std::max(f->last_end, f->advised_end);
+#if defined(POSIX_FADV_WILLNEED)
+    posix_fadvise(f->side_fd, (off_t) start, (off_t) (f->last_end + window - start), POSIX_FADV_WILLNEED);
+#elif defined(F_RDADVISE)
+    struct radvisory ra;
+    ra.ra_offset = (off_t) start;
+    ra.ra_count = (int) (f->last_end + window - start);
+    fcntl(f->side_fd, F_RDADVISE, &ra);
+#endif
+    f->advised_end = f->last_end + window;
+    bump(f->counters->readaheads);
+    bump(op_counters().readaheads);
+#endif
+}
+
+static int io_close(sqlite3_file * file) {
+    BWVfsFile * f = (BWVfsFile *) file;
+#ifdef BW_VFS_ADVISE
+    if(f->side_fd >= 0) {
+        close(f->side_fd);
+        f->side_fd = -1;
+    }
+#endif
+    int rc = SQLITE_OK;
+    if(f->real->pMethods) {
+        rc = f->real->pMethods->xClose(f->real);
+    }
+    return rc;
+}
+
+static int io_read(sqlite3_file * file, void * buf, int amount, sqlite3_int64 offset) {
+    BWVfsFile * f = (BWVfsFile *) file;
+    int rc = f->real->pMethods->xRead(f->real, buf, amount, offset);
+    IoCounters & op = op_counters();
+    bump(f->counters->reads);
+    bump(f->counters->bytes_read, amount);
+    bump(op.reads);
+    bump(op.bytes_read, amount);
+    track_read(f, offset, amount);
+    return rc;
+}
+
+static int io_write(sqlite3_file * file, const void * buf, int amount, sqlite3_int64 offset) {
+    BWVfsFile * f = (BWVfsFile *) file;
+    IoCounters & op = op_counters();
+    bump(f->counters->writes);
+    bump(f->counters->bytes_written, amount);
+    bump(op.writes);
+    bump(op.bytes_written, amount);
+    return f->real->pMethods->xWrite(f->real, buf, amount, offset);
+}
+
+static int io_sync(sqlite3_file * file, int flags) {
+    BWVfsFile * f = (BWVfsFile *) file;
+    bump(f->counters->syncs);
+    bump(op_counters().syncs);
+    return f->real->pMethods->xSync(f->real, flags);
+}
+
+// the rest pass straight through
+
+static int io_truncate(sqlite3_file * file, sqlite3_int64 size) {
+    return real_file(file)->pMethods->xTruncate(real_file(file), size);
+}
+
+static int io_file_size(sqlite3_file * file, sqlite3_int64 * size) {
+    return real_file(file)->pMethods->xFileSize(real_file(file), size);
+}
+
+static int io_lock(sqlite3_file * file, int lock) {
+    return real_file(file)->pMethods->xLock(real_file(file), lock);
+}
+
+static int io_unlock(sqlite3_file * file, int lock) {
+    return real_file(file)->pMethods->xUnlock(real_file(file), lock);
+}
+
+static int io_check_reserved_lock(sqlite3_file * file, int * out) {
+    return real_file(file)->pMethods->xCheckReservedLock(real_file(file), out);
+}
+
+static int io_file_control(sqlite3_file * file, int op, void * arg) {
+    return real_file(file)->pMethods->xFileControl(real_file(file), op, arg);
+}
+
+static int io_sector_size(sqlite3_file * file) {
+    return real_file(file)->pMethods->xSectorSize(real_file(file));
+}
+
+static int io_device_characteristics(sqlite3_file * file) {
+    return real_file(file)->pMethods->xDeviceCharacteristics(real_file(file));
+}
+
+static int io_shm_map(sqlite3_file * file, int page, int size, int extend, void volatile ** out) {
+    return real_file(file)->pMethods->xShmMap(real_file(file), page, size, extend, out);
+}
+
+static int io_shm_lock(sqlite3_file * file, int offset, int n, int flags) {
+    return real_file(file)->pMethods->xShmLock(real_file(file), offset, n, flags);
+}
+
+static void io_shm_barrier(sqlite3_file * file) {
+    real_file(file)->pMethods->xShmBarrier(real_file(file));
+}
+
+static int io_shm_unmap(sqlite3_file * file, int del) {
+    return real_file(file)->pMethods->xShmUnmap(real_file(file), del);
+}
+
+static int io_fetch(sqlite3_file * file, sqlite3_int64 offset, int amount, void ** out) {
+    return real_file(file)->pMethods->xFetch(real_file(file), offset, amount, out);
+}
+
+static int io_unfetch(sqlite3_file * file, sqlite3_int64 offset, void * page) {
+    return real_file(file)->pMethods->xUnfetch(real_file(file), offset, page);
+}
+
+// one table per version, matching what the real file supports
+static sqlite3_io_methods io_methods[3] = {
+    { 1, io_close, io_read, io_write, io_truncate, io_sync, io_file_size, io_lock, io_unlock,
+      io_check_reserved_lock, io_file_control, io_sector_size, io_device_characteristics,
+      nullptr, nullptr, nullptr, nullptr, nullptr, nullptr },
+    { 2, io_close, io_read, io_write, io_truncate, io_sync, io_file_size, io_lock, io_unlock,
+      io_check_reserved_lock, io_file_control, io_sector_size, io_device_characteristics,
+      io_shm_map, io_shm_lock, io_shm_barrier, io_shm_unmap, nullptr, nullptr },
+    { 3, io_close, io_read, io_write, io_truncate, io_sync, io_file_size, io_lock, io_unlock,
+      io_check_reserved_lock, io_file_control, io_sector_size, io_device_characteristics,
+      io_shm_map, io_shm_lock, io_shm_barrier, io_shm_unmap, io_fetch, io_unfetch },
+};
+
+// MARK: - vfs
+
+static sqlite3_vfs io_vfs;
+
+static sqlite3_vfs * root_vfs() {
+    return (sqlite3_vfs *) io_vfs.pAppData;
+}
+
+static int vfs_open(sqlite3_vfs *, const char * name, sqlite3_file * file, int flags, int * out_flags) {
+    BWVfsFile * f = (BWVfsFile *) file;
+    memset(f, 0, sizeof(BWVfsFile));
+    f->real = (sqlite3_file *) (f + 1);
+    f->side_fd = -1;
+    f->path = name;
+    f->main_db = name && (flags & SQLITE_OPEN_MAIN_DB);
+    f->counters = file_counters(name);
+    int rc = root_vfs()->xOpen(root_vfs(), name, f->real, flags, out_flags);
+    if(f->real->pMethods) {
+        int version = std::min(std::max(f->real->pMethods->iVersion, 1), 3);
+        f->base.pMethods = &io_methods[version - 1];
+    }
+    return rc;
+}
+
+static int vfs_delete(sqlite3_vfs *, const char * name, int sync_dir) {
+    return root_vfs()->xDelete(root_vfs(), name, sync_dir);
+}
+
+static int vfs_access(sqlite3_vfs *, const char * name, int flags, int * out) {
+    return root_vfs()->xAccess(root_vfs(), name, flags, out);
+}
+
+static int vfs_full_pathname(sqlite3_vfs *, const char * name, int n, char * out) {
+    return root_vfs()->xFullPathname(root_vfs(), name, n, out);
+}
+
+static void * vfs_dl_open(sqlite3_vfs *, const char * name) {
+    return root_vfs()->xDlOpen(root_vfs(), name);
+}
+
+static void vfs_dl_error(sqlite3_vfs *, int n, char * out) {
+    root_vfs()->xDlError(root_vfs(), n, out);
+}
+
+static void (*vfs_dl_sym(sqlite3_vfs *, void * handle, const char * symbol))(void) {
+    return root_vfs()->xDlSym(root_vfs(), handle, symbol);
+}
+
+static void vfs_dl_close(sqlite3_vfs *, void * handle) {
+    root_vfs()->xDlClose(root_vfs(), handle);
+}
+
+static int vfs_randomness(sqlite3_vfs *, int n, char * out) {
+    return root_vfs()->xRandomness(root_vfs(), n, out);
+}
+
+static int vfs_sleep(sqlite3_vfs *, int us) {
+    return root_vfs()->xSleep(root_vfs(), us);
+}
+
+static int vfs_current_time(sqlite3_vfs *, double * out) {
+    return root_vfs()->xCurrentTime(root_vfs(), out);
+}
+
+static int vfs_get_last_error(sqlite3_vfs *, int n, char * out) {
+    return root_vfs()->xGetLastError ? root_vfs()->xGetLastError(root_vfs(), n, out) : 0;
+}
+
+static int vfs_current_time_int64(sqlite3_vfs *, sqlite3_int64 * out) {
+    return root_vfs()->xCurrentTimeInt64(root_vfs(), out);
+}
+
+// MARK: - functions
+
+// registers once, wrapping whatever the default vfs is at the time
+bool io_vfs_register(bool make_default) {
+    static std::once_flag once;
+    static int rc = SQLITE_ERROR;
+    std::call_once(once, [] {
+        sqlite3_vfs * root = sqlite3_vfs_find(nullptr);
+        if(!root) {
+            return;
+        }
+        io_vfs.iVersion = std::min(root->iVersion, 2);
+        io_vfs.szOsFile = (int) sizeof(BWVfsFile) + root->szOsFile;
+        io_vfs.mxPathname = root->mxPathname;
+        io_vfs.zName = BW_VFS_NAME;
+        io_vfs.pAppData = root;
+        io_vfs.xOpen = vfs_open;
+        io_vfs.xDelete = vfs_delete;
+        io_vfs.xAccess = vfs_access;
+        io_vfs.xFullPathname = vfs_full_pathname;
+        io_vfs.xDlOpen = vfs_dl_open;
+        io_vfs.xDlError = vfs_dl_error;
+        io_vfs.xDlSym = vfs_dl_sym;
+        io_vfs.xDlClose = vfs_dl_close;
+        io_vfs.xRandomness = vfs_randomness;
+        io_vfs.xSleep = vfs_sleep;
+        io_vfs.xCurrentTime = vfs_current_time;
+        io_vfs.xGetLastError = vfs_get_last_error;
+        if(io_vfs.iVersion >= 2) {
+            io_vfs.xCurrentTimeInt64 = vfs_current_time_int64;
+        }
+        rc = sqlite3_vfs_register(&io_vfs, 0);
+    });
+    if(rc != SQLITE_OK) {
+        printf("io_vfs_register: cannot register %s\n", BW_VFS_NAME);
+        return false;
+    }
+    if(make_default) {
+        sqlite3_vfs_register(&io_vfs, 1);
+    }
+    return true;
+}
+
+// a window of 0 turns read-ahead off
+void io_vfs_readahead(int64_t window_bytes, int threshold) {
+    readahead_window = window_bytes;
+    seq_threshold = threshold > 0 ? threshold : DEFAULT_VFS_SEQ_THRESHOLD;
+}
+
+BWIoStats io_vfs_file_stats(const char * path) {
+    std::lock_guard<std::mutex> guard(files_lock);
+    auto it = files.find(path ? path : "(temp)");
+    return it == files.end() ? BWIoStats() : it->second->load();
+}
+
+std::vector<BWIoOpStats> io_vfs_op_stats() {
+    std::vector<BWIoOpStats> ops;
+    for(OpSlot & slot : op_slots) {
+        const char * op = slot.op.load(std::memory_order_acquire);
+        if(op) {
+            BWIoOpStats & s = ops.emplace_back();
+            s.op = op;
+            s.io = slot.io.load();
+        }
+    }
+    return ops;
+}
+
+// zeroes the counters, files and op slots stay registered
+void io_vfs_reset() {
+    {
+        std::lock_guard<std::mutex> guard(files_lock);
+        for(auto & file : files) {
+            file.second->clear();
+        }
+    }
+    for(OpSlot & slot : op_slots) {
+        slot.io.clear();
+    }
+}
+
+}
@@ -0,0 +1,57 @@
+//  BWVfs.h
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+#ifndef BWVFS_H
+#define BWVFS_H
+
+#include <sqlite3.h>
+#include <sqlcpp.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bw {
+
+#define BW_VFS_NAME "bwio"
+#define DEFAULT_VFS_READAHEAD (1 << 20)     // bytes advised ahead of a sequential read
+#define DEFAULT_VFS_SEQ_THRESHOLD 4         // sequential reads before read-ahead starts
+
+// I/O through the shim, per file or per operation
+struct BWIoStats {
+    int64_t reads = 0;
+    int64_t bytes_read = 0;
+    int64_t writes = 0;
+    int64_t bytes_written = 0;
+    int64_t syncs = 0;
+    int64_t seq_reads = 0;          // reads that continued a sequential run
+    int64_t readaheads = 0;         // read-ahead hints issued
+
+    BWIoStats & operator += (const BWIoStats & rhs);
+};
+
+// op is the BWTraceScope tag the I/O ran under, "(none)" outside any scope
+struct BWIoOpStats {
+    const char * op = nullptr;
+    BWIoStats io;
+};
+
+// a VFS that wraps the default one and counts I/O by file and by operation
+// sequential reads of a main database file (a full table scan, say)
+// get a read-ahead hint – posix_fadvise(WILLNEED), or F_RDADVISE on macOS –
+// issued on a side descriptor, so the next pages are in the OS cache
+// when sqlite asks for them
+// reads served from mmap don't pass through xRead and aren't counted
+// open through it with an OpenProfile whose vfs is BW_VFS_NAME,
+// or make it the default
+bool io_vfs_register(bool make_default = false);
+void io_vfs_readahead(int64_t window_bytes, int seq_threshold = DEFAULT_VFS_SEQ_THRESHOLD);
+
+// path as sqlite sees it – sqlite3_db_filename(), or with -wal/-journal
+BWIoStats io_vfs_file_stats(const char * path);
+std::vector<BWIoOpStats> io_vfs_op_stats();
+void io_vfs_reset();
+
+}
+
+#endif // BWVFS_H
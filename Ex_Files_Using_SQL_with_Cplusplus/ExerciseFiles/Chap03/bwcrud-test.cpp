@@ -39,6 +39,7 @@ int main() {
     const char ** row = nullptr;
 
     printf("BWCRUD version: %s, SQLite version: %s\n", db.version(), db.sqlite_version());
+    db.stmt_profiling(true);
 
     puts(sql_drop);
     db.sql_do(sql_drop);
@@ -91,6 +92,15 @@ int main() {
     db.get_rows();
     display_rows(db);
 
+    // full scans stand out here – find_rows can't use an index for LIKE
+    puts("statement profile");
+    for(const bw::BWStmtStats & s : db.stmt_stats()) {
+        printf("%4llu x %8.3f ms  rows %4llu  fullscan %4llu  sort %llu  %s\n",
+               (unsigned long long) s.execs, s.total_ms, (unsigned long long) s.rows,
+               (unsigned long long) s.fullscan_steps, (unsigned long long) s.sorts,
+               s.sql.c_str());
+    }
+
     puts("drop table");
     db.drop_table();
 
@@ -0,0 +1,661 @@
+//  bwsql-bench.cpp
+//  Copyright 2021 BHG [bw.org]
+//  as of 2026-10-17 bw
+
+// insert, point lookup, range scan, update and delete
+// for the raw sqlite3_* loops from Chap02, for BWSQL, and for BWCRUD
+// (and with -hot, for BWHotCache)
+// each suite runs under each open profile, to pick one for a workload
+// results go to stdout (or -o file) as JSON, progress to stderr
+//
+// build (from Chap03):
+//   c++ -std=c++17 -O2 -I../sqlite3/include bwsql-bench.cpp BW*.cpp -lsqlite3 -lpthread -o bwsql-bench
+//
+// usage:
+//   bwsql-bench [-n rows[,rows...]] [-ops count] [-p profile[,profile...]|all] [-hot ms]
+//               [-f dbfile] [-o out.json]
+//   -n     table sizes, default 1000,10000,100000 (up to 10000000)
+//   -p     open profiles from BWOpenProfile.h, default wal
+//          read-only profiles get a preloaded table and run only lookup and scan
+//          -p default,read-only-mmap compares plain open() with mmap and immutable=1
+//   -ops   lookups, updates and deletes per size, default 10000
+//   -hot   add the in-memory BWHotCache, persisting every ms (0 only at the end)
+//          it adds a persist op, and a "hot" section with the persist times and
+//          the longest window of unpersisted changes
+//   -f     scratch database, default DB_PATH/bench.db
+//   -o     JSON output file, default stdout
+
+#include <cstdio>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "BWCRUD.h"
+#include "BWHotCache.h"
+
+constexpr const char * db_file = DB_PATH "/bench.db";
+constexpr const char * table_name = "bench";
+constexpr long default_rows[] = { 1000, 10000, 100000 };
+constexpr long default_ops = 10000;
+constexpr long scan_length = 100;
+
+constexpr const char * sql_create = "CREATE TABLE IF NOT EXISTS bench"
+                                    "( id INTEGER PRIMARY KEY, a TEXT, b TEXT, c TEXT )";
+constexpr const char * sql_insert = "INSERT INTO bench (a,b,c) VALUES (?, ?, ?)";
+constexpr const char * sql_lookup = "SELECT * FROM bench WHERE id = ?";
+constexpr const char * sql_scan =   "SELECT * FROM bench WHERE id BETWEEN ? AND ?";
+constexpr const char * sql_update = "UPDATE bench SET a = ?, b = ?, c = ? WHERE id = ?";
+constexpr const char * sql_delete = "DELETE FROM bench WHERE id = ?";
+constexpr const char * sql_begin =  "BEGIN";
+constexpr const char * sql_commit = "COMMIT";
+
+using bench_clock = std::chrono::steady_clock;
+
+static int hot_persist_ms = -1;             // -hot, off if negative
+
+// MARK: - results
+
+struct OpResult {
+    const char * profile = nullptr;
+    const char * impl = nullptr;
+    const char * op = nullptr;
+    long rows = 0;              // table size
+    long ops = 0;
+    long items = 0;             // rows read or changed
+    double seconds = 0;
+    double ops_per_sec = 0;
+    double p50_us = 0;
+    double p95_us = 0;
+    double p99_us = 0;
+    double max_us = 0;
+};
+
+// BWHotCache over one suite
+struct HotResult {
+    const char * profile = nullptr;
+    long rows = 0;
+    int persist_ms = 0;         // the timer, 0 for none
+    bw::BWHotStats stats;
+};
+
+// times each op, one latency sample per call
+class Recorder {
+    std::vector<uint64_t> _ns;
+    bench_clock::time_point _start;
+
+public:
+    explicit Recorder(long ops) {
+        _ns.reserve((size_t) ops);
+        _start = bench_clock::now();
+    }
+
+    template<typename F> long time(F && f) {
+        bench_clock::time_point t0 = bench_clock::now();
+        long items = f();
+        _ns.push_back((uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now() - t0).count());
+        return items;
+    }
+
+    // the total includes BEGIN/COMMIT, the samples don't
+    OpResult finish(const char * profile, const char * impl, const char * op, long rows, long items) {
+        OpResult r;
+        r.profile = profile;
+        r.impl = impl;
+        r.op = op;
+        r.rows = rows;
+        r.ops = (long) _ns.size();
+        r.items = items;
+        r.seconds = std::chrono::duration<double>(bench_clock::now() - _start).count();
+        r.ops_per_sec = r.seconds > 0 ? (double) r.ops / r.seconds : 0;
+        if(_ns.empty()) {
+            return r;
+        }
+        std::sort(_ns.begin(), _ns.end());
+        auto pct = [this](double q) {
+            size_t index = std::min(_ns.size() - 1, (size_t) (q * (double) _ns.size()));
+            return (double) _ns[index] / 1000.0;
+        };
+        r.p50_us = pct(0.50);
+        r.p95_us = pct(0.95);
+        r.p99_us = pct(0.99);
+        r.max_us = (double) _ns.back() / 1000.0;
+        return r;
+    }
+};
+
+// MARK: - implementations
+
+// the Chap02 way – prepare once, bind, step, reset
+class RawBench {
+    sqlite3 * _db = nullptr;
+    sqlite3_stmt * _insert = nullptr;
+    sqlite3_stmt * _lookup = nullptr;
+    sqlite3_stmt * _scan = nullptr;
+    sqlite3_stmt * _update = nullptr;
+    sqlite3_stmt * _delete = nullptr;
+
+public:
+    static constexpr const char * name = "raw";
+    static constexpr bool hot = false;
+
+    RawBench(const char * filename, const bw::OpenProfile & profile) {
+        if(bw::open_with_profile(filename, &_db, profile) != SQLITE_OK) {
+            fprintf(stderr, "%s/raw: profile not applied: %s\n", profile.name, sqlite3_errmsg(_db));
+        }
+        sqlite3_prepare_v2(_db, sql_insert, -1, &_insert, nullptr);
+        sqlite3_prepare_v2(_db, sql_lookup, -1, &_lookup, nullptr);
+        sqlite3_prepare_v2(_db, sql_scan, -1, &_scan, nullptr);
+        sqlite3_prepare_v2(_db, sql_update, -1, &_update, nullptr);
+        sqlite3_prepare_v2(_db, sql_delete, -1, &_delete, nullptr);
+    }
+    ~RawBench() {
+        sqlite3_finalize(_insert);
+        sqlite3_finalize(_lookup);
+        sqlite3_finalize(_scan);
+        sqlite3_finalize(_update);
+        sqlite3_finalize(_delete);
+        sqlite3_close(_db);
+    }
+
+    void begin() { sqlite3_exec(_db, sql_begin, nullptr, nullptr, nullptr); }
+    void commit() { sqlite3_exec(_db, sql_commit, nullptr, nullptr, nullptr); }
+
+    long insert(const char * a, const char * b, const char * c) {
+        sqlite3_bind_text(_insert, 1, a, -1, SQLITE_STATIC);
+        sqlite3_bind_text(_insert, 2, b, -1, SQLITE_STATIC);
+        sqlite3_bind_text(_insert, 3, c, -1, SQLITE_STATIC);
+        sqlite3_step(_insert);
+        sqlite3_reset(_insert);
+        return sqlite3_changes(_db);
+    }
+    long lookup(long id) {
+        sqlite3_bind_int64(_lookup, 1, id);
+        long count = _read_rows(_lookup);
+        sqlite3_reset(_lookup);
+        return count;
+    }
+    long scan(long lo, long hi) {
+        sqlite3_bind_int64(_scan, 1, lo);
+        sqlite3_bind_int64(_scan, 2, hi);
+        long count = _read_rows(_scan);
+        sqlite3_reset(_scan);
+        return count;
+    }
+    long update(long id, const char * a, const char * b, const char * c) {
+        sqlite3_bind_text(_update, 1, a, -1, SQLITE_STATIC);
+        sqlite3_bind_text(_update, 2, b, -1, SQLITE_STATIC);
+        sqlite3_bind_text(_update, 3, c, -1, SQLITE_STATIC);
+        sqlite3_bind_int64(_update, 4, id);
+        sqlite3_step(_update);
+        sqlite3_reset(_update);
+        return sqlite3_changes(_db);
+    }
+    long remove(long id) {
+        sqlite3_bind_int64(_delete, 1, id);
+        sqlite3_step(_delete);
+        sqlite3_reset(_delete);
+        return sqlite3_changes(_db);
+    }
+
+private:
+    // every column as text, the same work fetch_row() does
+    static long _read_rows(sqlite3_stmt * stmt) {
+        long count = 0;
+        int col_count = sqlite3_column_count(stmt);
+        while(sqlite3_step(stmt) == SQLITE_ROW) {
+            for(int i = 0; i < col_count; ++i) {
+                sqlite3_column_text(stmt, i);
+            }
+            ++count;
+        }
+        return count;
+    }
+};
+
+// typed templates, statement cache and profiler
+class BWSQLBench {
+    bw::BWSQL _db;
+
+public:
+    static constexpr const char * name = "bwsql";
+    static constexpr bool hot = false;
+
+    BWSQLBench(const char * filename, const bw::OpenProfile & profile) : _db(filename, profile) {}
+
+    void begin() { _db.sql_do(sql_begin); }
+    void commit() { _db.sql_do(sql_commit); }
+
+    long insert(const char * a, const char * b, const char * c) {
+        return _db.sql_do(BW_SQL(sql_insert), a, b, c);
+    }
+    long lookup(long id) {
+        _db.sql_prepare(BW_SQL(sql_lookup), (int64_t) id);
+        return _read_rows();
+    }
+    long scan(long lo, long hi) {
+        _db.sql_prepare(BW_SQL(sql_scan), (int64_t) lo, (int64_t) hi);
+        return _read_rows();
+    }
+    long update(long id, const char * a, const char * b, const char * c) {
+        return _db.sql_do(BW_SQL(sql_update), a, b, c, (int64_t) id);
+    }
+    long remove(long id) {
+        return _db.sql_do(BW_SQL(sql_delete), (int64_t) id);
+    }
+
+private:
+    long _read_rows() {
+        long count = 0;
+        while(_db.fetch_row()) {
+            ++count;
+        }
+        return count;
+    }
+};
+
+// the CRUD calls – BWCRUD has no range call, so
+// the scan uses the inherited BWSQL::sql_prepare()
+class BWCRUDBench {
+    bw::BWCRUD _db;
+
+public:
+    static constexpr const char * name = "bwcrud";
+    static constexpr bool hot = false;
+
+    BWCRUDBench(const char * filename, const bw::OpenProfile & profile)
+    : _db(filename, table_name, profile) {}
+
+    void begin() { _db.begin(); }
+    void commit() { _db.commit(); }
+
+    long insert(const char * a, const char * b, const char * c) {
+        return _db.insert(0, a, b, c);
+    }
+    long lookup(long id) {
+        long count = 0;
+        if(_db.get_row((int) id)) {
+            ++count;
+            while(_db.fetch_row()) {
+                ++count;
+            }
+        }
+        return count;
+    }
+    long scan(long lo, long hi) {
+        _db.sql_prepare(sql_scan, (int64_t) lo, (int64_t) hi);
+        long count = 0;
+        while(_db.fetch_row()) {
+            ++count;
+        }
+        return count;
+    }
+    long update(long id, const char * a, const char * b, const char * c) {
+        return _db.update_row((int) id, a, b, c);
+    }
+    long remove(long id) {
+        return _db.delete_row((int) id);
+    }
+};
+
+// BWSQLBench from memory – the profile doesn't apply,
+// the timer persists alongside the ops
+class HotBench {
+    bw::BWHotCache _db;
+
+public:
+    static constexpr const char * name = "bwsql-hot";
+    static constexpr bool hot = true;
+
+    HotBench(const char * filename, const bw::OpenProfile &) : _db(filename, hot_persist_ms) {}
+
+    void begin() { _db.sql_do(sql_begin); }
+    void commit() { _db.sql_do(sql_commit); }
+
+    long insert(const char * a, const char * b, const char * c) {
+        return _db.sql_do(BW_SQL(sql_insert), a, b, c);
+    }
+    long lookup(long id) {
+        _db.sql_prepare(BW_SQL(sql_lookup), (int64_t) id);
+        return _read_rows();
+    }
+    long scan(long lo, long hi) {
+        _db.sql_prepare(BW_SQL(sql_scan), (int64_t) lo, (int64_t) hi);
+        return _read_rows();
+    }
+    long update(long id, const char * a, const char * b, const char * c) {
+        return _db.sql_do(BW_SQL(sql_update), a, b, c, (int64_t) id);
+    }
+    long remove(long id) {
+        return _db.sql_do(BW_SQL(sql_delete), (int64_t) id);
+    }
+
+    long persist() {
+        _db.persist();
+        return (long) _db.stats().pages;
+    }
+    bw::BWHotStats stats() { return _db.stats(); }
+
+private:
+    long _read_rows() {
+        long count = 0;
+        while(_db.fetch_row()) {
+            ++count;
+        }
+        return count;
+    }
+};
+
+// MARK: - driver
+
+static std::vector<HotResult> hot_results;
+
+// xorshift64, the same ids for every implementation
+class IdSource {
+    uint64_t _state;
+    long _max;
+
+public:
+    IdSource(long max, uint64_t seed = 0x9E3779B97F4A7C15ull) : _state(seed), _max(max) {}
+    long next() {
+        _state ^= _state << 13;
+        _state ^= _state >> 7;
+        _state ^= _state << 17;
+        return 1 + (long) (_state % (uint64_t) _max);
+    }
+};
+
+// fresh file with an empty table
+// the journal mode is left to the profile – WAL set here would stay
+// in the file, and "default" would run in WAL too
+void fresh_db(const char * filename) {
+    std::string base = filename;
+    remove(base.c_str());
+    remove((base + "-wal").c_str());
+    remove((base + "-shm").c_str());
+    remove((base + "-journal").c_str());
+    sqlite3 * db = nullptr;
+    sqlite3_open(filename, &db);
+    sqlite3_exec(db, sql_create, nullptr, nullptr, nullptr);
+    sqlite3_close(db);
+}
+
+// rows for a profile that can't write them itself
+void populate(const char * filename, long rows) {
+    sqlite3 * db = nullptr;
+    sqlite3_stmt * stmt = nullptr;
+    char a[32];
+    char b[32];
+    sqlite3_open(filename, &db);
+    sqlite3_exec(db, sql_begin, nullptr, nullptr, nullptr);
+    sqlite3_prepare_v2(db, sql_insert, -1, &stmt, nullptr);
+    for(long i = 0; i < rows; ++i) {
+        snprintf(a, sizeof(a), "name-%ld", i);
+        snprintf(b, sizeof(b), "%ld", i * 7);
+        sqlite3_bind_text(stmt, 1, a, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, b, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, "benchmark row", -1, SQLITE_STATIC);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_exec(db, sql_commit, nullptr, nullptr, nullptr);
+    sqlite3_close(db);
+}
+
+template<typename Impl>
+void run_suite(const char * filename, const bw::OpenProfile & profile, long rows, long ops,
+               std::vector<OpResult> & results) {
+    bool writable = !(profile.flags & SQLITE_OPEN_READONLY);
+    fresh_db(filename);
+    if(!writable) {
+        populate(filename, rows);
+    }
+    Impl impl(filename, profile);
+    char a[32];
+    char b[32];
+    const char * c = "benchmark row";
+    long items = 0;
+
+    fprintf(stderr, "%s/%s: %ld rows\n", profile.name, Impl::name, rows);
+
+    // insert – all rows in one transaction
+    if(writable) {
+        Recorder rec(rows);
+        impl.begin();
+        for(long i = 0; i < rows; ++i) {
+            snprintf(a, sizeof(a), "name-%ld", i);
+            snprintf(b, sizeof(b), "%ld", i * 7);
+            items += rec.time([&] { return impl.insert(a, b, c); });
+        }
+        impl.commit();
+        results.push_back(rec.finish(profile.name, Impl::name, "insert", rows, items));
+    }
+
+    // point lookup by primary key
+    {
+        long n = std::min(rows, ops);
+        IdSource ids(rows);
+        Recorder rec(n);
+        items = 0;
+        for(long i = 0; i < n; ++i) {
+            long id = ids.next();
+            items += rec.time([&] { return impl.lookup(id); });
+        }
+        results.push_back(rec.finish(profile.name, Impl::name, "lookup", rows, items));
+    }
+
+    // range scan of scan_length rows
+    {
+        long n = std::min(std::max(rows / scan_length, 1L), std::max(ops / 10, 1L));
+        long span = std::max(rows - scan_length, 1L);
+        IdSource ids(span, 0x2545F4914F6CDD1Dull);
+        Recorder rec(n);
+        items = 0;
+        for(long i = 0; i < n; ++i) {
+            long lo = ids.next();
+            items += rec.time([&] { return impl.scan(lo, lo + scan_length - 1); });
+        }
+        results.push_back(rec.finish(profile.name, Impl::name, "scan", rows, items));
+    }
+
+    // update by primary key, one transaction
+    if(writable) {
+        long n = std::min(rows, ops);
+        IdSource ids(rows, 0xD1B54A32D192ED03ull);
+        Recorder rec(n);
+        items = 0;
+        impl.begin();
+        for(long i = 0; i < n; ++i) {
+            long id = ids.next();
+            snprintf(a, sizeof(a), "upd-%ld", i);
+            snprintf(b, sizeof(b), "%ld", i * 11);
+            items += rec.time([&] { return impl.update(id, a, b, c); });
+        }
+        impl.commit();
+        results.push_back(rec.finish(profile.name, Impl::name, "update", rows, items));
+    }
+
+    // delete distinct, evenly spaced ids, one transaction
+    if(writable) {
+        long n = std::min(rows, ops);
+        long stride = std::max(rows / n, 1L);
+        Recorder rec(n);
+        items = 0;
+        impl.begin();
+        for(long i = 0; i < n; ++i) {
+            long id = 1 + i * stride;
+            items += rec.time([&] { return impl.remove(id); });
+        }
+        impl.commit();
+        results.push_back(rec.finish(profile.name, Impl::name, "delete", rows, items));
+    }
+
+    // one final persist, then what the timer saw
+    if constexpr (Impl::hot) {
+        Recorder rec(1);
+        items = rec.time([&] { return impl.persist(); });
+        results.push_back(rec.finish(profile.name, Impl::name, "persist", rows, items));
+        HotResult & h = hot_results.emplace_back();
+        h.profile = profile.name;
+        h.rows = rows;
+        h.persist_ms = hot_persist_ms;
+        h.stats = impl.stats();
+    }
+}
+
+// the profile with the best ops_per_sec for each impl, op and size
+std::vector<const OpResult *> fastest(const std::vector<OpResult> & results) {
+    std::vector<const OpResult *> best;
+    for(const OpResult & r : results) {
+        auto it = std::find_if(best.begin(), best.end(), [&r](const OpResult * b) {
+            return !strcmp(b->impl, r.impl) && !strcmp(b->op, r.op) && b->rows == r.rows;
+        });
+        if(it == best.end()) {
+            best.push_back(&r);
+        } else if(r.ops_per_sec > (*it)->ops_per_sec) {
+            *it = &r;
+        }
+    }
+    return best;
+}
+
+void write_json(FILE * out, const std::vector<OpResult> & results) {
+    fprintf(out, "{\n  \"sqlite_version\": \"%s\",\n  \"bwsql_version\": \"%s\",\n  \"results\": [\n",
+            sqlite3_libversion(), _BWSQL_VERSION);
+    for(size_t i = 0; i < results.size(); ++i) {
+        const OpResult & r = results[i];
+        fprintf(out, "    {\"profile\": \"%s\", \"impl\": \"%s\", \"op\": \"%s\", \"rows\": %ld, "
+                "\"ops\": %ld, \"items\": %ld, \"seconds\": %.6f, \"ops_per_sec\": %.1f, "
+                "\"p50_us\": %.3f, \"p95_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f}%s\n",
+                r.profile, r.impl, r.op, r.rows, r.ops, r.items, r.seconds, r.ops_per_sec,
+                r.p50_us, r.p95_us, r.p99_us, r.max_us,
+                (i < results.size() - 1) ? "," : "");
+    }
+    fprintf(out, "  ],\n  \"fastest\": [\n");
+    std::vector<const OpResult *> best = fastest(results);
+    for(size_t i = 0; i < best.size(); ++i) {
+        const OpResult & r = *best[i];
+        fprintf(out, "    {\"impl\": \"%s\", \"op\": \"%s\", \"rows\": %ld, \"profile\": \"%s\", "
+                "\"ops_per_sec\": %.1f}%s\n",
+                r.impl, r.op, r.rows, r.profile, r.ops_per_sec,
+                (i < best.size() - 1) ? "," : "");
+    }
+    fprintf(out, "  ]");
+    if(!hot_results.empty()) {
+        fprintf(out, ",\n  \"hot\": [\n");
+        for(size_t i = 0; i < hot_results.size(); ++i) {
+            const HotResult & h = hot_results[i];
+            fprintf(out, "    {\"profile\": \"%s\", \"rows\": %ld, \"persist_ms\": %d, \"load_ms\": %.3f, "
+                    "\"persists\": %llu, \"skipped\": %llu, \"pages\": %lld, \"persist_ms_avg\": %.3f, "
+                    "\"persist_ms_max\": %.3f, \"window_ms_max\": %.1f}%s\n",
+                    h.profile, h.rows, h.persist_ms, h.stats.load_ms,
+                    (unsigned long long) h.stats.persists, (unsigned long long) h.stats.skipped,
+                    (long long) h.stats.pages,
+                    h.stats.persists ? h.stats.persist_ms_total / (double) h.stats.persists : 0.0,
+                    h.stats.persist_ms_max, h.stats.window_ms_max,
+                    (i < hot_results.size() - 1) ? "," : "");
+        }
+        fprintf(out, "  ]");
+    }
+    fprintf(out, "\n}\n");
+}
+
+// "1000,1e5,10000000"
+std::vector<long> parse_rows(const char * arg) {
+    std::vector<long> rows;
+    const char * p = arg;
+    while(*p) {
+        char * end = nullptr;
+        double value = strtod(p, &end);
+        if(end == p) {
+            break;
+        }
+        if(value >= 1) {
+            rows.push_back((long) value);
+        }
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return rows;
+}
+
+// "oltp,bulk-load" or "all"
+std::vector<const bw::OpenProfile *> parse_profiles(const char * arg) {
+    std::vector<const bw::OpenProfile *> profiles;
+    if(!strcmp(arg, "all")) {
+        for(const bw::OpenProfile * const * p = bw::all_profiles(); *p; ++p) {
+            profiles.push_back(*p);
+        }
+        return profiles;
+    }
+    std::string list = arg;
+    size_t pos = 0;
+    while(pos <= list.size()) {
+        size_t end = list.find(',', pos);
+        if(end == std::string::npos) end = list.size();
+        std::string name = list.substr(pos, end - pos);
+        const bw::OpenProfile * profile = bw::find_profile(name.c_str());
+        if(!profile) {
+            fprintf(stderr, "unknown profile %s\n", name.c_str());
+            return {};
+        }
+        profiles.push_back(profile);
+        pos = end + 1;
+    }
+    return profiles;
+}
+
+int main(int argc, char ** argv) {
+    std::vector<long> rows(std::begin(default_rows), std::end(default_rows));
+    long ops = default_ops;
+    const char * filename = db_file;
+    const char * out_name = nullptr;
+    std::vector<const bw::OpenProfile *> profiles { &bw::profile_wal };
+
+    for(int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if(arg == "-n" && i + 1 < argc) {
+            rows = parse_rows(argv[++i]);
+        } else if(arg == "-ops" && i + 1 < argc) {
+            ops = std::max(atol(argv[++i]), 1L);
+        } else if(arg == "-p" && i + 1 < argc) {
+            profiles = parse_profiles(argv[++i]);
+            if(profiles.empty()) {
+                return 1;
+            }
+        } else if(arg == "-hot" && i + 1 < argc) {
+            hot_persist_ms = std::max(atoi(argv[++i]), 0);
+        } else if(arg == "-f" && i + 1 < argc) {
+            filename = argv[++i];
+        } else if(arg == "-o" && i + 1 < argc) {
+            out_name = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [-n rows[,rows...]] [-ops count] [-p profile[,profile...]|all] "
+                    "[-hot ms] [-f dbfile] [-o out.json]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<OpResult> results;
+    for(long n : rows) {
+        for(const bw::OpenProfile * profile : profiles) {
+            run_suite<RawBench>(filename, *profile, n, ops, results);
+            run_suite<BWSQLBench>(filename, *profile, n, ops, results);
+            run_suite<BWCRUDBench>(filename, *profile, n, ops, results);
+            if(hot_persist_ms >= 0) {
+                run_suite<HotBench>(filename, *profile, n, ops, results);
+            }
+        }
+    }
+
+    FILE * out = out_name ? fopen(out_name, "w") : stdout;
+    if(!out) {
+        fprintf(stderr, "cannot open %s\n", out_name);
+        return 1;
+    }
+    write_json(out, results);
+    if(out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
@@ -27,9 +27,9 @@ constexpr const char * insert_strings[] = {
 
 // print all rows from a prepared statement
 void disp_rows(bw::BWSQL & db) {
-    for(const char ** row = db.fetch_row(); row; row = db.fetch_row()) {
-        for(int i = 0; i < db.num_sql_columns(); ++i) {
-            printf("%s%s", row[i], (i < db.num_sql_columns() - 1) ? ", " : "\n");
+    for(bw::RowView row : db.rows()) {
+        for(int i = 0; i < row.num_columns(); ++i) {
+            printf("%s%s", row.get<const char *>(i), (i < row.num_columns() - 1) ? ", " : "\n");
         }
     }
 }
@@ -58,9 +58,13 @@ int main() {
         const char * col1 = insert_strings[index++];
         const char * col2 = insert_strings[index++];
         const char * col3 = insert_strings[index++];
-        count += db.sql_do(sql_insert, col1, col2, col3);
+        count += db.sql_do(BW_SQL(sql_insert), col1, col2, col3);
     }
     printf("%d rows inserted\n", count);
+    bw::BWStmtCacheStats cs = db.stmt_cache_stats();
+    printf("statement cache: %llu hits, %llu misses, %llu evictions\n",
+           (unsigned long long) cs.hits, (unsigned long long) cs.misses,
+           (unsigned long long) cs.evictions);
     puts(sql_commit);
     db.sql_do(sql_commit);
 